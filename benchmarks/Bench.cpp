@@ -0,0 +1,341 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Workloads.hpp"
+#include "../src/interpreter/Interpreter.hpp"
+#include "../src/optimizer/Optimizer.hpp"
+#include "../src/cli/Arguments.hpp"
+#include "../src/cli/SourceFile.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define WS_BENCH_ISOLATED 1
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// Times every workload stage by stage and prints one JSON document to stdout, a readable summary to stderr.
+// With --compare it instead runs fib, factorial and tower on the switch, threaded and jit engines and reports their speedup over switch.
+// USAGE: bench [--engine=<name>] [--no-optimize] [--quick] [--compare] [<tests directory>]
+namespace WS{
+    namespace Bench{
+        constexpr int REPETITIONS = 3;
+
+        struct Settings{
+            std::string engine_name = "threaded";
+            Options options;
+            bool quick = false;
+            bool compare = false;
+            std::string tests = "./tests";
+        };
+
+        // The fastest of REPETITIONS runs, in seconds
+        template<typename Run>
+        double best_of(Run&& run){
+            double best = 0;
+            for(int i = 0; i < REPETITIONS; ++i){
+                const auto start = std::chrono::steady_clock::now();
+                run();
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                best = i == 0 || seconds < best ? seconds : best;
+            }
+            return best;
+        }
+
+        std::string json_string(std::string_view text){
+            std::string result = "\"";
+            for(const char c: text){
+                if(c == '"' || c == '\\'){
+                    result += '\\';
+                    result += c;
+                }
+                else if(static_cast<unsigned char>(c) < 0x20){
+                    result += ' ';
+                }
+                else{
+                    result += c;
+                }
+            }
+            return result + '"';
+        }
+
+        Bytecode build(const ParsingResult& parsed, const Options& options){
+            Bytecode bytecode = compile(link(parsed), options.engine == Engine::BIGNUM);
+            if(options.optimize){
+                return optimize(bytecode);
+            }
+            return bytecode;
+        }
+
+        // The JSON object of one workload without its closing brace, peak memory is only known to whoever waits for the run
+        std::string measure(const Case& test, const Options& options){
+            std::ostringstream json;
+            json << std::setprecision(9);
+            json << "{\"name\": " << json_string(test.name) << ", \"size\": " << test.size;
+            try{
+                const Workload workload = test.build();
+                size_t tokens = 0;
+                const double tokenize_seconds = best_of([&](){
+                    TokenStream stream = tokenize(workload.source);
+                    for(tokens = 0; stream.has_next(); ++tokens){
+                        stream.next();
+                    }
+                });
+                const double parse_seconds = best_of([&](){
+                    parse_tokens(tokenize(workload.source));
+                });
+
+                // Compiling includes what the engine prepares once per program, the jit's native code among it
+                const ParsingResult parsed = parse_tokens(tokenize(workload.source));
+                const double compile_seconds = best_of([&](){
+                    const Bytecode bytecode = build(parsed, options);
+                    prepare(bytecode, options.engine, options.limits);
+                });
+
+                const Bytecode bytecode = build(parsed, options);
+                const Prepared prepared = prepare(bytecode, options.engine, options.limits);
+                const double interpret_seconds = best_of([&](){
+                    StringInput input(workload.input);
+                    StringOutput output;
+                    interpret(bytecode, prepared, input, output, options.limits);
+                });
+
+                StringInput input(workload.input);
+                StringOutput output;
+                const unsigned long long executed = count_instructions(bytecode, input, output, options.limits);
+
+                json << ", \"source_bytes\": " << workload.source.size()
+                     << ", \"tokens\": " << tokens
+                     << ", \"instructions\": " << bytecode.size()
+                     << ", \"executed\": " << executed
+                     << ", \"tokenize_seconds\": " << tokenize_seconds
+                     << ", \"parse_seconds\": " << parse_seconds
+                     << ", \"compile_seconds\": " << compile_seconds
+                     << ", \"interpret_seconds\": " << interpret_seconds
+                     << ", \"tokens_per_second\": " << (tokenize_seconds > 0 ? static_cast<double>(tokens) / tokenize_seconds : 0)
+                     << ", \"instructions_per_second\": " << (interpret_seconds > 0 ? static_cast<double>(executed) / interpret_seconds : 0);
+
+                std::cerr << std::fixed << std::setprecision(2) << workload.name << '/' << workload.size
+                          << ": tokenize " << tokenize_seconds * 1000 << " ms, parse " << parse_seconds * 1000 << " ms, interpret " << interpret_seconds * 1000 << " ms, "
+                          << (interpret_seconds > 0 ? static_cast<double>(executed) / interpret_seconds / 1e6 : 0) << " M instructions/s\n";
+            }
+            catch(const WhitespaceRuntimeException& ex){
+                json << ", \"error\": " << json_string(ex.what());
+                std::cerr << test.name << '/' << test.size << ": " << ex.what() << '\n';
+            }
+            catch(const WhitespaceCompileError& ex){
+                json << ", \"error\": " << json_string(ex.what());
+                std::cerr << test.name << '/' << test.size << ": " << ex.what() << '\n';
+            }
+            catch(const std::runtime_error& ex){
+                json << ", \"error\": " << json_string(ex.what());
+                std::cerr << test.name << '/' << test.size << ": " << ex.what() << '\n';
+            }
+            return json.str();
+        }
+
+#ifdef WS_BENCH_ISOLATED
+        // Runs the workload in a child process, so its peak RSS is its own and not the maximum of everything before it
+        std::string run(const Case& test, const Options& options){
+            std::cout.flush();      // The child would write out whatever is still buffered a second time
+            int channel[2];
+            if(pipe(channel) != 0){
+                throw std::runtime_error("Couldn't create a pipe");
+            }
+
+            const pid_t child = fork();
+            if(child < 0){
+                throw std::runtime_error("Couldn't fork");
+            }
+            if(child == 0){
+                close(channel[0]);
+                const std::string json = measure(test, options);
+                for(size_t written = 0; written < json.size();){
+                    const ssize_t count = write(channel[1], json.data() + written, json.size() - written);
+                    if(count <= 0){
+                        _exit(1);
+                    }
+                    written += static_cast<size_t>(count);
+                }
+                _exit(0);
+            }
+
+            close(channel[1]);
+            std::string json;
+            char chunk[4096];
+            for(ssize_t count; (count = read(channel[0], chunk, sizeof(chunk))) > 0;){
+                json.append(chunk, static_cast<size_t>(count));
+            }
+            close(channel[0]);
+
+            int status = 0;
+            struct rusage usage;
+            if(wait4(child, &status, 0, &usage) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || json.empty()){
+                return "{\"name\": " + json_string(test.name) + ", \"size\": " + std::to_string(test.size) + ", \"error\": \"crashed\"}";
+            }
+#ifdef __APPLE__
+            const long peak_kib = usage.ru_maxrss / 1024;
+#else
+            const long peak_kib = usage.ru_maxrss;
+#endif
+            return json + ", \"peak_rss_kib\": " + std::to_string(peak_kib) + '}';
+        }
+#else
+        std::string run(const Case& test, const Options& options){
+            return measure(test, options) + ", \"peak_rss_kib\": null}";
+        }
+#endif
+
+        std::string read_file(const std::string& path){
+            const CLI::SourceFile file(path);
+            return std::string(file.content());
+        }
+
+        // The programs in tests/ with inputs that keep them busy for a while, size is the number or the length of the text they get
+        std::vector<Case> programs(const std::string& directory, const bool quick){
+            const long long text_size = quick ? 10000 : 1000000;
+            const auto number = [&directory](const std::string& name, const long long n){
+                return Case{name, n, [=](){ return Workload{name, n, read_file(directory + '/' + name + ".ws"), std::to_string(n) + '\n'}; }};
+            };
+            const auto text = [&directory, text_size](const std::string& name){
+                return Case{name, text_size, [=](){ return Workload{name, text_size, read_file(directory + '/' + name + ".ws"), std::string(static_cast<size_t>(text_size), 'x') + '\n'}; }};
+            };
+            return std::vector<Case>{number("fib", 90), number("factorial", 20), number("tower", quick ? 10 : 18), text("reverse"), text("hello_user")};
+        }
+
+        struct Contender{
+            const char* name;
+            Engine::Engine engine;
+        };
+        constexpr Contender CONTENDERS[] = {{"switch", Engine::SWITCH}, {"threaded", Engine::THREADED}, {"jit", Engine::JIT}};
+
+        // Runs runs times on the same prepared bytecode, one run of fib or factorial is over too quickly to time on its own
+        double time_engine(const Bytecode& bytecode, const Workload& workload, const Options& options, const Engine::Engine engine, const long long runs){
+            const Prepared prepared = prepare(bytecode, engine, options.limits);
+            return best_of([&](){
+                for(long long i = 0; i < runs; ++i){
+                    StringInput input(workload.input);
+                    StringOutput output;
+                    interpret(bytecode, prepared, input, output, options.limits);
+                }
+            });
+        }
+
+        // The JSON object comparing the engines on one workload, the number of runs is doubled until switch takes long enough to time
+        std::string compare(const Case& test, const Options& options, const bool quick){
+            std::ostringstream json;
+            json << std::setprecision(9);
+            json << "{\"name\": " << json_string(test.name) << ", \"size\": " << test.size;
+            try{
+                const Workload workload = test.build();
+                const Bytecode bytecode = build(parse_tokens(tokenize(workload.source)), options);
+
+                const double minimum_seconds = quick ? 0.02 : 0.2;
+                long long runs = 1;
+                while(time_engine(bytecode, workload, options, Engine::SWITCH, runs) < minimum_seconds){
+                    runs *= 2;
+                }
+                json << ", \"runs\": " << runs;
+                std::cerr << std::fixed << std::setprecision(2) << workload.name << '/' << workload.size << " x" << runs << ':';
+
+                double baseline = 0;
+                for(const Contender& contender: CONTENDERS){
+                    const double seconds = time_engine(bytecode, workload, options, contender.engine, runs);
+                    baseline = contender.engine == Engine::SWITCH ? seconds : baseline;
+                    const double speedup = seconds > 0 ? baseline / seconds : 0;
+                    json << ", \"" << contender.name << "_seconds\": " << seconds << ", \"" << contender.name << "_speedup\": " << speedup;
+                    std::cerr << ' ' << contender.name << ' ' << seconds * 1000 << " ms (" << speedup << "x)";
+                }
+                std::cerr << '\n';
+            }
+            catch(const WhitespaceRuntimeException& ex){
+                json << ", \"error\": " << json_string(ex.what());
+                std::cerr << test.name << '/' << test.size << ": " << ex.what() << '\n';
+            }
+            catch(const WhitespaceCompileError& ex){
+                json << ", \"error\": " << json_string(ex.what());
+                std::cerr << test.name << '/' << test.size << ": " << ex.what() << '\n';
+            }
+            catch(const std::runtime_error& ex){
+                json << ", \"error\": " << json_string(ex.what());
+                std::cerr << test.name << '/' << test.size << ": " << ex.what() << '\n';
+            }
+            return json.str() + '}';
+        }
+
+        Settings parse_settings(int argc, char const *argv[]){
+            Settings settings;
+            for(int i = 1; i < argc; ++i){
+                const std::string_view arg = argv[i];
+                if(arg.substr(0, 9) == "--engine="){
+                    settings.options.engine = CLI::parse_engine(arg.substr(9));
+                    settings.engine_name = std::string(arg.substr(9));
+                }
+                else if(arg == "--no-optimize"){
+                    settings.options.optimize = false;
+                }
+                else if(arg == "--quick"){
+                    settings.quick = true;
+                }
+                else if(arg == "--compare"){
+                    settings.compare = true;
+                }
+                else if(arg.substr(0, 2) == "--"){
+                    throw std::invalid_argument(std::string("Unknown flag ") + std::string(arg));
+                }
+                else{
+                    settings.tests = std::string(arg);
+                }
+            }
+            return settings;
+        }
+    }
+}
+
+int main(int argc, char const *argv[]){
+    WS::Bench::Settings settings;
+    std::vector<WS::Bench::Case> cases;
+    try{
+        settings = WS::Bench::parse_settings(argc, argv);
+        cases = WS::Bench::programs(settings.tests, settings.quick);
+    }
+    catch(const std::exception& ex){
+        std::cerr << "ERROR: " << ex.what() << '\n';
+        return 1;
+    }
+
+    if(settings.compare){
+        std::cout << "{\n  \"optimize\": " << (settings.options.optimize ? "true" : "false")
+                  << ",\n  \"repetitions\": " << WS::Bench::REPETITIONS
+                  << ",\n  \"comparison\": [";
+        bool first = true;
+        for(const WS::Bench::Case& test: cases){
+            if(test.name == "fib" || test.name == "factorial" || test.name == "tower"){
+                std::cout << (first ? "\n    " : ",\n    ") << WS::Bench::compare(test, settings.options, settings.quick) << std::flush;
+                first = false;
+            }
+        }
+        std::cout << "\n  ]\n}\n";
+        return 0;
+    }
+    for(WS::Bench::Case& test: WS::Bench::synthetic(settings.quick)){
+        cases.push_back(std::move(test));
+    }
+
+    std::cout << "{\n  \"engine\": " << WS::Bench::json_string(settings.engine_name)
+              << ",\n  \"optimize\": " << (settings.options.optimize ? "true" : "false")
+              << ",\n  \"repetitions\": " << WS::Bench::REPETITIONS
+              << ",\n  \"benchmarks\": [";
+    for(size_t i = 0; i < cases.size(); ++i){
+        const std::string json = WS::Bench::run(cases[i], settings.options);
+        std::cout << (i == 0 ? "\n    " : ",\n    ") << json << std::flush;
+    }
+    std::cout << "\n  ]\n}\n";
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "Workloads.hpp"
+
+namespace WS{
+    namespace Bench{
+        void Assembler::number(const long long n){
+            text += n < 0 ? '\t' : ' ';
+            const unsigned long long magnitude = n < 0 ? 0ULL - static_cast<unsigned long long>(n) : static_cast<unsigned long long>(n);
+            for(int bit = 63; bit >= 0; --bit){
+                if((magnitude >> bit) != 0){
+                    text += ((magnitude >> bit) & 1) != 0 ? '\t' : ' ';
+                }
+            }
+            text += '\n';
+        }
+
+        void Assembler::label(const uint32_t id){
+            for(int bit = 31; bit >= 0; --bit){
+                if((id >> bit) != 0){
+                    text += ((id >> bit) & 1) != 0 ? '\t' : ' ';
+                }
+            }
+            text += '\n';
+        }
+
+        Assembler& Assembler::push(const long long n){ text += "  "; number(n); return *this; }
+        Assembler& Assembler::dup(){ text += " \n "; return *this; }
+        Assembler& Assembler::copy(const long long n){ text += " \t "; number(n); return *this; }
+        Assembler& Assembler::swap(){ text += " \n\t"; return *this; }
+        Assembler& Assembler::drop(){ text += " \n\n"; return *this; }
+        Assembler& Assembler::add(){ text += "\t   "; return *this; }
+        Assembler& Assembler::sub(){ text += "\t  \t"; return *this; }
+        Assembler& Assembler::mul(){ text += "\t  \n"; return *this; }
+        Assembler& Assembler::mod(){ text += "\t \t\t"; return *this; }
+        Assembler& Assembler::store(){ text += "\t\t "; return *this; }
+        Assembler& Assembler::load(){ text += "\t\t\t"; return *this; }
+        Assembler& Assembler::mark(const uint32_t id){ text += "\n  "; label(id); return *this; }
+        Assembler& Assembler::call(const uint32_t id){ text += "\n \t"; label(id); return *this; }
+        Assembler& Assembler::jmp(const uint32_t id){ text += "\n \n"; label(id); return *this; }
+        Assembler& Assembler::jz(const uint32_t id){ text += "\n\t "; label(id); return *this; }
+        Assembler& Assembler::jn(const uint32_t id){ text += "\n\t\t"; label(id); return *this; }
+        Assembler& Assembler::ret(){ text += "\n\t\n"; return *this; }
+        Assembler& Assembler::end(){ text += "\n\n\n"; return *this; }
+        Assembler& Assembler::outc(){ text += "\t\n  "; return *this; }
+        Assembler& Assembler::outn(){ text += "\t\n \t"; return *this; }
+        Assembler& Assembler::readc(){ text += "\t\n\t "; return *this; }
+        Assembler& Assembler::comment(const std::string& comment){ text += comment; return *this; }
+
+        Assembler& Assembler::loop_until(const uint32_t loop, const long long n){
+            return push(1).add().dup().push(n).sub().jn(loop);
+        }
+
+        const std::string& Assembler::source() const{
+            return text;
+        }
+
+        Workload recursion(const long long size){
+            Assembler a;
+            a.push(size).call(1).outn().end();
+            a.mark(1).dup().jz(2).push(1).sub().call(1).ret();
+            a.mark(2).ret();
+            return Workload{"recursion", size, a.source(), ""};
+        }
+
+        Workload heap(const long long size){
+            Assembler a;
+            a.push(0).mark(1).dup().dup().store().loop_until(1, size).drop();
+            a.push(size).push(0).store();
+            a.push(0).mark(2).push(size).push(size).load().copy(2).load().add().store().loop_until(2, size).drop();
+            a.push(size).load().outn().end();
+            return Workload{"heap", size, a.source(), ""};
+        }
+
+        Workload arithmetic(const long long size){
+            Assembler a;
+            a.push(0).push(0);
+            a.mark(1).swap().push(31).mul().copy(1).add().push(1000003).mod().swap().loop_until(1, size).drop();
+            a.outn().end();
+            return Workload{"arithmetic", size, a.source(), ""};
+        }
+
+        Workload io(const long long size){
+            Assembler a;
+            a.push(0).mark(1).push(0).readc().push(0).load().outc().loop_until(1, size).end();
+
+            std::string input;
+            input.reserve(static_cast<size_t>(size));
+            for(long long i = 0; i < size; ++i){
+                input += static_cast<char>('a' + i % 26);
+            }
+            return Workload{"io", size, a.source(), input};
+        }
+
+        Workload straight_line(const long long size){
+            Assembler a;
+            for(long long i = 0; i < size; ++i){
+                a.push(i).drop();
+            }
+            a.end();
+            return Workload{"straight_line", size, a.source(), ""};
+        }
+
+        Workload comments(const long long size){
+            // 114 bytes of prose, one line of a commented listing
+            const std::string line = "//_Pushes_the_loop_index_and_drops_it_again,_the_instructions_are_the_only_whitespace_on_this_line_of_the_listing.";
+            Assembler a;
+            for(long long i = 0; i < size; ++i){
+                a.comment(line).push(i).comment(line).drop();
+            }
+            a.end();
+            return Workload{"comments", size, a.source(), ""};
+        }
+
+        std::vector<Case> synthetic(const bool quick){
+            using Generator = Workload (*)(const long long);
+            const std::vector<std::pair<std::string, Generator>> generators{
+                {"recursion", recursion}, {"heap", heap}, {"arithmetic", arithmetic}, {"io", io}, {"straight_line", straight_line},
+                {"comments", comments},
+            };
+            const std::vector<long long> sizes = quick ? std::vector<long long>{1000, 10000} : std::vector<long long>{10000, 100000, 1000000};
+
+            std::vector<Case> result;
+            for(const auto& [name, generate]: generators){
+                for(const long long size: sizes){
+                    result.push_back(Case{name, size, [generate = generate, size](){ return generate(size); }});
+                }
+            }
+            return result;
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace WS{
+    namespace Bench{
+        // Writes whitespace source one instruction at a time, numbers and labels are encoded in binary like the spec wants
+        class Assembler{
+        private:
+            std::string text;
+
+            void number(const long long n);
+            void label(const uint32_t id);
+
+        public:
+            Assembler& push(const long long n);
+            Assembler& dup();
+            Assembler& copy(const long long n);
+            Assembler& swap();
+            Assembler& drop();
+            Assembler& add();
+            Assembler& sub();
+            Assembler& mul();
+            Assembler& mod();
+            Assembler& store();
+            Assembler& load();
+            Assembler& mark(const uint32_t id);
+            Assembler& call(const uint32_t id);
+            Assembler& jmp(const uint32_t id);
+            Assembler& jz(const uint32_t id);
+            Assembler& jn(const uint32_t id);
+            Assembler& ret();
+            Assembler& end();
+            Assembler& outc();
+            Assembler& outn();
+            Assembler& readc();
+
+            // Text the tokenizer skips, must not contain spaces, tabs or newlines
+            Assembler& comment(const std::string& text);
+
+            // Closes a counting loop over the index on top of the stack: leaves i + 1 there and jumps back to loop while it is below n
+            Assembler& loop_until(const uint32_t loop, const long long n);
+
+            const std::string& source() const;
+        };
+
+        struct Workload{
+            std::string name;
+            long long size;
+            std::string source;
+            std::string input;      // Joined on '\n' like the CLI does
+        };
+
+        // A call chain size deep that unwinds again
+        Workload recursion(const long long size);
+
+        // Fills size heap cells, then sums them up through the heap
+        Workload heap(const long long size);
+
+        // size rounds of x = (x * 31 + i) mod 1000003
+        Workload arithmetic(const long long size);
+
+        // Echoes size input characters one by one
+        Workload io(const long long size);
+
+        // size straight-line push / drop pairs, mostly tokenizer and parser work
+        Workload straight_line(const long long size);
+
+        // size push / drop pairs, each behind a line of comment text that is far longer than its instructions,
+        // times how fast the tokenizer skips comments
+        Workload comments(const long long size);
+
+        // A workload that is only built where it runs, so the process that starts all of them stays small
+        struct Case{
+            std::string name;
+            long long size;
+            std::function<Workload()> build;
+        };
+
+        // All synthetic workloads at every size, the largest ones left out if quick
+        std::vector<Case> synthetic(const bool quick);
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace WS{
+    namespace Engine{
+        enum Engine{
+            SWITCH,     // One switch over the opcode per instruction
+            THREADED,   // Direct threaded code using labels-as-values, falls back to SWITCH on other compilers
+            JIT,        // Native x86-64 code, falls back to THREADED on other hosts
+            BIGNUM,     // Arbitrary precision values, a switch like SWITCH that leaves small values unboxed
+        };
+    }
+
+    // Bounds a running program has to stay within, breaking one raises a WhitespaceRuntimeException.
+    // They meter the bytecode that runs, so the optimized one unless Options::optimize is off, see optimizer/Optimizer.hpp
+    struct Limits{
+        static constexpr size_t DEFAULT_CALL_DEPTH = size_t(1) << 24;
+        static constexpr size_t UNLIMITED = SIZE_MAX;
+
+        size_t call_depth = DEFAULT_CALL_DEPTH;     // Nested FLOW_CALLs, CallStackOverflow beyond it
+        size_t stack_depth = UNLIMITED;             // Values on the stack, ValueStackOverflow beyond it
+        size_t heap_cells = UNLIMITED;              // Distinct heap addresses stored to, HeapLimitExceeded beyond it
+        size_t instructions = UNLIMITED;            // Instructions executed, a superinstruction counts once. InstructionLimitExceeded beyond it
+        size_t milliseconds = UNLIMITED;            // Wall time of the run, TimeLimitExceeded beyond it
+
+        // Whether the engines have to meter the run, see interpreter/Budget.hpp
+        bool metered() const{
+            return instructions != UNLIMITED || milliseconds != UNLIMITED;
+        }
+    };
+
+    struct Options{
+        Engine::Engine engine = Engine::THREADED;
+        bool optimize = true;       // Run the bytecode optimizer, see optimizer/Optimizer.hpp
+        Limits limits;
+    };
+}
@@ -0,0 +1,142 @@
+#include "BigContext.hpp"
+#include "../exceptions/Exceptions.hpp"
+#include "../exceptions/Messages.hpp"
+
+namespace WS{
+    BigContext::BigContext(const Limits& limits): max_call_depth(limits.call_depth), max_stack_depth(limits.stack_depth), max_heap_cells(limits.heap_cells){}
+
+    void BigContext::throw_if_value_stack_empty(){
+        if(value_stack.empty()){
+            throw ValueStackEmpty(Messages::VALUE_STACK_EMPTY);
+        }
+    }
+
+    void BigContext::throw_if_value_stack_full(){
+        if(value_stack.size() >= max_stack_depth){
+            throw ValueStackOverflow(Messages::VALUE_STACK_OVERFLOW_PREFIX + std::to_string(max_stack_depth));
+        }
+    }
+
+    void BigContext::throw_if_value_stack_too_small(const size_t size){
+        if(value_stack.size() < size){
+            throw_value_stack_too_small(size, value_stack.size());
+        }
+    }
+
+    void BigContext::throw_value_stack_too_small(const size_t size, const size_t actual){
+        throw ValueStackTooSmall(Messages::VALUE_STACK_TOO_SMALL_PREFIX + std::to_string(size) + Messages::VALUE_STACK_TOO_SMALL_INFIX + std::to_string(actual));
+    }
+
+    Value& BigContext::heap_at(const Value& addr){
+        if(addr.is_small()){
+            const auto found = heap.find(addr.small);
+            if(found != heap.end()){
+                return found->second;
+            }
+        }
+        else{
+            const auto found = big_heap.find(*addr.big);
+            if(found != big_heap.end()){
+                return found->second;
+            }
+        }
+        throw UndefinedHeapAccess(Messages::UNDEFINED_HEAP_PREFIX + addr.to_string() + Messages::UNDEFINED_HEAP_SUFFIX);
+    }
+
+    void BigContext::heap_store(const Value& addr, Value&& value){
+        const bool inserted = addr.is_small() ? heap.insert_or_assign(addr.small, std::move(value)).second : big_heap.insert_or_assign(*addr.big, std::move(value)).second;
+        if(inserted && heap.size() + big_heap.size() > max_heap_cells){
+            throw HeapLimitExceeded(Messages::HEAP_LIMIT_PREFIX + std::to_string(max_heap_cells) + Messages::HEAP_LIMIT_SUFFIX);
+        }
+    }
+
+    Value BigContext::stack_pop(){
+        throw_if_value_stack_empty();
+        Value value = std::move(value_stack.back());
+        value_stack.pop_back();
+        return value;
+    }
+
+    void BigContext::stack_push(Value&& value){
+        throw_if_value_stack_full();
+        value_stack.push_back(std::move(value));
+    }
+
+    void BigContext::stack_discard_n(const long long n){
+        if(!value_stack.empty()){
+            Value top = std::move(value_stack.back());
+            value_stack.pop_back();
+            if(n < 0 || static_cast<size_t>(n) >= value_stack.size()){
+                value_stack.clear();
+            }
+            else{
+                value_stack.resize(value_stack.size() - static_cast<size_t>(n));
+            }
+            value_stack.push_back(std::move(top));
+        }
+    }
+
+    void BigContext::stack_swap_top(){
+        throw_if_value_stack_too_small(2);
+        std::swap(value_stack[value_stack.size() - 1], value_stack[value_stack.size() - 2]);
+    }
+
+    void BigContext::stack_dup_n(const size_t n){
+        throw_if_value_stack_too_small(n + 1);
+        throw_if_value_stack_full();
+        Value value = value_stack[value_stack.size() - 1 - n];
+        value_stack.push_back(std::move(value));
+    }
+
+    const Value& BigContext::stack_top(){
+        throw_if_value_stack_too_small(1);
+        return value_stack.back();
+    }
+
+    void BigContext::call(const size_t return_address){
+        if(call_stack.size() >= max_call_depth){
+            throw CallStackOverflow(Messages::CALL_STACK_OVERFLOW_PREFIX + std::to_string(max_call_depth));
+        }
+        call_stack.push_back(return_address);
+    }
+
+    size_t BigContext::ret(){
+        if(call_stack.empty()){
+            throw CallStackEmpty(Messages::CALL_STACK_EMPTY);
+        }
+        const size_t addr = call_stack.back();
+        call_stack.pop_back();
+        return addr;
+    }
+
+    void BigContext::heap_pop(){
+        throw_if_value_stack_too_small(2);
+        Value value = stack_pop();
+        const Value addr = stack_pop();
+        heap_store(addr, std::move(value));
+    }
+
+    void BigContext::heap_push(){
+        const Value addr = stack_pop();
+        value_stack.push_back(heap_at(addr));
+    }
+
+    void BigContext::store(Value&& value){
+        const Value addr = stack_pop();
+        heap_store(addr, std::move(value));
+    }
+
+    void BigContext::heap_store_imm(const long long num){
+        if(value_stack.empty()){
+            throw_value_stack_too_small(2, 1);
+        }
+        store(Value(num));
+    }
+
+    void BigContext::heap_store_top(const long long addr){
+        if(value_stack.empty()){
+            throw_value_stack_too_small(2, 1);
+        }
+        heap_store(Value(addr), stack_pop());
+    }
+}
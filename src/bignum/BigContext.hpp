@@ -0,0 +1,52 @@
+#pragma once
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "BigInt.hpp"
+#include "../Options.hpp"
+
+namespace WS{
+    // The Context of the bignum engine, same checks and exceptions but every cell is a Value
+    class BigContext{
+    private:
+        std::vector<Value> value_stack;
+        std::vector<size_t> call_stack;
+        size_t max_call_depth;
+        size_t max_stack_depth;
+        std::unordered_map<long long, Value> heap;
+        std::map<BigInt, Value> big_heap;       // Addresses that don't fit a long long
+        size_t max_heap_cells;
+
+        void throw_if_value_stack_empty();
+        void throw_if_value_stack_full();
+        void throw_if_value_stack_too_small(const size_t size);
+        [[noreturn]] void throw_value_stack_too_small(const size_t size, const size_t actual);
+
+        Value& heap_at(const Value& addr);
+        void heap_store(const Value& addr, Value&& value);
+
+    public:
+        BigContext(const Limits& limits = Limits());
+
+        Value stack_pop();
+        void stack_push(Value&& value);
+
+        void stack_discard_n(const long long n);
+        void stack_swap_top();
+        void stack_dup_n(const size_t n);
+        // Raises like stack_dup_n(0)
+        const Value& stack_top();
+
+        void call(const size_t return_address);
+        size_t ret();
+
+        void heap_pop();
+        void heap_push();
+        void store(Value&& value);
+
+        // Fails like STACK_PUSH; HEAP_POP and STACK_PUSH; STACK_SWAP; HEAP_POP would
+        void heap_store_imm(const long long num);
+        void heap_store_top(const long long addr);
+    };
+}
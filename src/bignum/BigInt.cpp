@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <stdexcept>
+
+#include "BigInt.hpp"
+
+namespace WS{
+    BigInt::BigInt(): negative(false){}
+
+    BigInt::BigInt(const long long value): negative(value < 0){
+        unsigned long long magnitude = negative ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+        while(magnitude != 0){
+            limbs.push_back(static_cast<uint32_t>(magnitude));
+            magnitude >>= 32;
+        }
+    }
+
+    void BigInt::trim(){
+        while(!limbs.empty() && limbs.back() == 0){
+            limbs.pop_back();
+        }
+        if(limbs.empty()){
+            negative = false;
+        }
+    }
+
+    bool BigInt::is_zero() const{
+        return limbs.empty();
+    }
+
+    bool BigInt::is_negative() const{
+        return negative;
+    }
+
+    unsigned long long low_bits(const std::vector<uint32_t>& limbs){
+        unsigned long long magnitude = 0;
+        if(limbs.size() > 0){
+            magnitude |= limbs[0];
+        }
+        if(limbs.size() > 1){
+            magnitude |= static_cast<unsigned long long>(limbs[1]) << 32;
+        }
+        return magnitude;
+    }
+
+    bool BigInt::fits() const{
+        const unsigned long long limit = static_cast<unsigned long long>(LLONG_MAX) + (negative ? 1 : 0);
+        return limbs.size() <= 2 && low_bits(limbs) <= limit;
+    }
+
+    long long BigInt::to_long_long() const{
+        return wrapped();
+    }
+
+    long long BigInt::wrapped() const{
+        const unsigned long long magnitude = low_bits(limbs);
+        return static_cast<long long>(negative ? 0ULL - magnitude : magnitude);
+    }
+
+    void BigInt::multiply_add(const uint32_t factor, const uint32_t addend){
+        uint64_t carry = addend;
+        for(uint32_t& limb: limbs){
+            const uint64_t product = static_cast<uint64_t>(limb) * factor + carry;
+            limb = static_cast<uint32_t>(product);
+            carry = product >> 32;
+        }
+        if(carry != 0){
+            limbs.push_back(static_cast<uint32_t>(carry));
+        }
+        trim();
+    }
+
+    // Divides the magnitude in place and returns the remainder
+    uint32_t divide_small(std::vector<uint32_t>& limbs, const uint32_t divisor){
+        uint64_t remainder = 0;
+        for(size_t i = limbs.size(); i-- > 0;){
+            const uint64_t current = (remainder << 32) | limbs[i];
+            limbs[i] = static_cast<uint32_t>(current / divisor);
+            remainder = current % divisor;
+        }
+        while(!limbs.empty() && limbs.back() == 0){
+            limbs.pop_back();
+        }
+        return static_cast<uint32_t>(remainder);
+    }
+
+    std::string BigInt::to_string() const{
+        if(is_zero()){
+            return "0";
+        }
+        std::vector<uint32_t> rest = limbs;
+        std::string digits;
+        while(!rest.empty()){
+            uint32_t chunk = divide_small(rest, 1000000000u);
+            for(int i = 0; i < 9 && (chunk != 0 || !rest.empty()); ++i){
+                digits += static_cast<char>('0' + chunk % 10);
+                chunk /= 10;
+            }
+        }
+        if(negative){
+            digits += '-';
+        }
+        std::reverse(digits.begin(), digits.end());
+        return digits;
+    }
+
+    int compare_magnitude(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs){
+        if(lhs.size() != rhs.size()){
+            return lhs.size() < rhs.size() ? -1 : 1;
+        }
+        for(size_t i = lhs.size(); i-- > 0;){
+            if(lhs[i] != rhs[i]){
+                return lhs[i] < rhs[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    std::vector<uint32_t> add_magnitude(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs){
+        const std::vector<uint32_t>& longer = lhs.size() >= rhs.size() ? lhs : rhs;
+        const std::vector<uint32_t>& shorter = lhs.size() >= rhs.size() ? rhs : lhs;
+        std::vector<uint32_t> result;
+        result.reserve(longer.size() + 1);
+        uint64_t carry = 0;
+        for(size_t i = 0; i < longer.size(); ++i){
+            const uint64_t sum = static_cast<uint64_t>(longer[i]) + (i < shorter.size() ? shorter[i] : 0) + carry;
+            result.push_back(static_cast<uint32_t>(sum));
+            carry = sum >> 32;
+        }
+        if(carry != 0){
+            result.push_back(static_cast<uint32_t>(carry));
+        }
+        return result;
+    }
+
+    // lhs has to be at least as large as rhs
+    std::vector<uint32_t> subtract_magnitude(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs){
+        std::vector<uint32_t> result;
+        result.reserve(lhs.size());
+        int64_t borrow = 0;
+        for(size_t i = 0; i < lhs.size(); ++i){
+            int64_t difference = static_cast<int64_t>(lhs[i]) - (i < rhs.size() ? rhs[i] : 0) - borrow;
+            borrow = difference < 0 ? 1 : 0;
+            if(difference < 0){
+                difference += static_cast<int64_t>(1) << 32;
+            }
+            result.push_back(static_cast<uint32_t>(difference));
+        }
+        return result;
+    }
+
+    BigInt operator-(const BigInt& value){
+        BigInt result = value;
+        if(!result.is_zero()){
+            result.negative = !result.negative;
+        }
+        return result;
+    }
+
+    BigInt operator+(const BigInt& lhs, const BigInt& rhs){
+        BigInt result;
+        if(lhs.negative == rhs.negative){
+            result.limbs = add_magnitude(lhs.limbs, rhs.limbs);
+            result.negative = lhs.negative;
+        }
+        else if(compare_magnitude(lhs.limbs, rhs.limbs) >= 0){
+            result.limbs = subtract_magnitude(lhs.limbs, rhs.limbs);
+            result.negative = lhs.negative;
+        }
+        else{
+            result.limbs = subtract_magnitude(rhs.limbs, lhs.limbs);
+            result.negative = rhs.negative;
+        }
+        result.trim();
+        return result;
+    }
+
+    BigInt operator-(const BigInt& lhs, const BigInt& rhs){
+        return lhs + -rhs;
+    }
+
+    BigInt operator*(const BigInt& lhs, const BigInt& rhs){
+        BigInt result;
+        if(lhs.is_zero() || rhs.is_zero()){
+            return result;
+        }
+        result.limbs.assign(lhs.limbs.size() + rhs.limbs.size(), 0);
+        for(size_t i = 0; i < lhs.limbs.size(); ++i){
+            uint64_t carry = 0;
+            for(size_t j = 0; j < rhs.limbs.size(); ++j){
+                const uint64_t current = static_cast<uint64_t>(lhs.limbs[i]) * rhs.limbs[j] + result.limbs[i + j] + carry;
+                result.limbs[i + j] = static_cast<uint32_t>(current);
+                carry = current >> 32;
+            }
+            result.limbs[i + rhs.limbs.size()] = static_cast<uint32_t>(carry);
+        }
+        result.negative = lhs.negative != rhs.negative;
+        result.trim();
+        return result;
+    }
+
+    bool operator==(const BigInt& lhs, const BigInt& rhs){
+        return lhs.negative == rhs.negative && lhs.limbs == rhs.limbs;
+    }
+
+    bool operator<(const BigInt& lhs, const BigInt& rhs){
+        if(lhs.negative != rhs.negative){
+            return lhs.negative;
+        }
+        const int comparison = compare_magnitude(lhs.limbs, rhs.limbs);
+        return lhs.negative ? comparison > 0 : comparison < 0;
+    }
+
+    // Truncating division of the magnitudes, shift and subtract one bit at a time unless the divisor is a single limb
+    void divide_magnitude(const std::vector<uint32_t>& dividend, const std::vector<uint32_t>& divisor, std::vector<uint32_t>& quotient, std::vector<uint32_t>& remainder){
+        if(divisor.size() == 1){
+            quotient = dividend;
+            const uint32_t rest = divide_small(quotient, divisor[0]);
+            remainder.clear();
+            if(rest != 0){
+                remainder.push_back(rest);
+            }
+            return;
+        }
+
+        quotient.assign(dividend.size(), 0);
+        remainder.clear();
+        for(size_t bit = dividend.size() * 32; bit-- > 0;){
+            // remainder = remainder * 2 + next bit of the dividend
+            uint32_t carry = (dividend[bit / 32] >> (bit % 32)) & 1;
+            for(uint32_t& limb: remainder){
+                const uint32_t next = limb >> 31;
+                limb = (limb << 1) | carry;
+                carry = next;
+            }
+            if(carry != 0){
+                remainder.push_back(carry);
+            }
+            if(compare_magnitude(remainder, divisor) >= 0){
+                remainder = subtract_magnitude(remainder, divisor);
+                while(!remainder.empty() && remainder.back() == 0){
+                    remainder.pop_back();
+                }
+                quotient[bit / 32] |= static_cast<uint32_t>(1) << (bit % 32);
+            }
+        }
+        while(!quotient.empty() && quotient.back() == 0){
+            quotient.pop_back();
+        }
+    }
+
+    BigInt floor_divide(const BigInt& dividend, const BigInt& divisor){
+        BigInt quotient;
+        BigInt remainder;
+        divide_magnitude(dividend.limbs, divisor.limbs, quotient.limbs, remainder.limbs);
+        quotient.negative = dividend.negative != divisor.negative;
+        quotient.trim();
+        if(!remainder.is_zero() && dividend.negative != divisor.negative){
+            return quotient - BigInt(1);
+        }
+        return quotient;
+    }
+
+    BigInt floor_modulo(const BigInt& dividend, const BigInt& divisor){
+        BigInt quotient;
+        BigInt remainder;
+        divide_magnitude(dividend.limbs, divisor.limbs, quotient.limbs, remainder.limbs);
+        remainder.negative = dividend.negative;
+        remainder.trim();
+        if(!remainder.is_zero() && dividend.negative != divisor.negative){
+            return remainder + divisor;
+        }
+        return remainder;
+    }
+
+    BigInt parse_big_integer(std::string_view text, const int base){
+        size_t i = 0;
+        while(i < text.size() && std::isspace(static_cast<unsigned char>(text[i]))){
+            ++i;
+        }
+
+        bool negative = false;
+        if(i < text.size() && (text[i] == '+' || text[i] == '-')){
+            negative = text[i] == '-';
+            ++i;
+        }
+        if(base == 16 && i + 2 < text.size() && text[i] == '0' && (text[i + 1] == 'x' || text[i + 1] == 'X') && std::isxdigit(static_cast<unsigned char>(text[i + 2]))){
+            i += 2;
+        }
+
+        BigInt result;
+        const size_t first = i;
+        for(; i < text.size(); ++i){
+            const char c = static_cast<char>(std::tolower(static_cast<unsigned char>(text[i])));
+            const int digit = std::isdigit(static_cast<unsigned char>(c)) ? c - '0' : (c >= 'a' && c <= 'z' ? c - 'a' + 10 : base);
+            if(digit >= base){
+                break;
+            }
+            result.multiply_add(static_cast<uint32_t>(base), static_cast<uint32_t>(digit));
+        }
+        if(i == first){
+            throw std::invalid_argument("stoll");
+        }
+        return negative ? -result : result;
+    }
+
+    Value::Value(BigInt&& value): small(0){
+        if(value.fits()){
+            small = value.to_long_long();
+        }
+        else{
+            big = std::make_shared<const BigInt>(std::move(value));
+        }
+    }
+
+    BigInt Value::to_big() const{
+        return is_small() ? BigInt(small) : *big;
+    }
+
+    long long Value::wrapped() const{
+        return is_small() ? small : big->wrapped();
+    }
+
+    std::string Value::to_string() const{
+        return is_small() ? std::to_string(small) : big->to_string();
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace WS{
+    // Signed integer of any size, stored as sign and magnitude
+    class BigInt{
+    private:
+        bool negative;
+        std::vector<uint32_t> limbs;    // Magnitude, least significant first, never with a leading zero limb. Zero has none
+
+        void trim();
+
+    public:
+        BigInt();
+        BigInt(const long long value);
+        BigInt(const BigInt&) = default;
+        BigInt(BigInt&&) = default;
+        BigInt& operator=(const BigInt&) = default;
+        BigInt& operator=(BigInt&&) = default;
+
+        bool is_zero() const;
+        bool is_negative() const;
+
+        // Whether the value is representable as a long long
+        bool fits() const;
+        // Only meaningful if fits()
+        long long to_long_long() const;
+        // The lowest 64 bits in two's complement, what a long long computation would have wrapped around to
+        long long wrapped() const;
+
+        // this = this * factor + addend, for building numbers digit by digit
+        void multiply_add(const uint32_t factor, const uint32_t addend);
+
+        std::string to_string() const;
+
+        friend BigInt operator-(const BigInt& value);
+        friend BigInt operator+(const BigInt& lhs, const BigInt& rhs);
+        friend BigInt operator-(const BigInt& lhs, const BigInt& rhs);
+        friend BigInt operator*(const BigInt& lhs, const BigInt& rhs);
+        friend bool operator==(const BigInt& lhs, const BigInt& rhs);
+        friend bool operator<(const BigInt& lhs, const BigInt& rhs);
+
+        // Rounding towards negative infinity like the Whitespace DIVIDE / MODULO, divisor must not be zero
+        friend BigInt floor_divide(const BigInt& dividend, const BigInt& divisor);
+        friend BigInt floor_modulo(const BigInt& dividend, const BigInt& divisor);
+    };
+
+    // Parses like std::stoll(text, 0, base) and raises std::invalid_argument if there are no digits, but never overflows
+    BigInt parse_big_integer(std::string_view text, const int base);
+
+    // A value stack or heap cell: an unboxed long long that only moves to a shared BigInt once it stops fitting
+    class Value{
+    public:
+        long long small;
+        std::shared_ptr<const BigInt> big;     // Set if and only if the value doesn't fit small
+
+        Value(): small(0){}
+        Value(const long long small): small(small){}
+        Value(BigInt&& value);
+
+        bool is_small() const{
+            return big == nullptr;
+        }
+
+        BigInt to_big() const;
+
+        // The lowest 64 bits, see BigInt::wrapped
+        long long wrapped() const;
+
+        std::string to_string() const;
+    };
+}
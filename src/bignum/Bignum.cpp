@@ -0,0 +1,190 @@
+#include "Bignum.hpp"
+#include "BigContext.hpp"
+#include "../interpreter/Interpreter.hpp"
+#include "../interpreter/Budget.hpp"
+#include "../interpreter/Operations.hpp"
+
+namespace WS{
+    // b <op> a, overflowing into a BigInt instead of wrapping around
+    Value arithmetic(const InstructionType::InstructionType type, const Value& b, const Value& a){
+        if(a.is_small() && b.is_small()){
+            const std::optional<long long> result = Operations::checked(type, b.small, a.small);
+            if(result){
+                return Value(*result);
+            }
+        }
+
+        const BigInt lhs = b.to_big();
+        const BigInt rhs = a.to_big();
+        switch(type){
+            case InstructionType::ARITHMETIC_ADD:
+                return Value(lhs + rhs);
+            case InstructionType::ARITHMETIC_SUB:
+                return Value(lhs - rhs);
+            case InstructionType::ARITHMETIC_MULTIPLICATE:
+                return Value(lhs * rhs);
+            case InstructionType::ARITHMETIC_DIVIDE:
+                return Value(floor_divide(lhs, rhs));
+            case InstructionType::ARITHMETIC_MODULO:
+            default:
+                return Value(floor_modulo(lhs, rhs));
+        }
+    }
+
+    void arithmetic(BigContext& ctx, const InstructionType::InstructionType type){
+        const Value a = ctx.stack_pop();
+        const bool divides = type == InstructionType::ARITHMETIC_DIVIDE || type == InstructionType::ARITHMETIC_MODULO;
+        if(divides && a.is_small() && a.small == 0){
+            throw DivideByZeroException(Messages::DIVISION_BY_ZERO);
+        }
+        const Value b = ctx.stack_pop();
+        ctx.stack_push(arithmetic(type, b, a));
+    }
+
+    bool is_zero(const Value& value){
+        return value.is_small() && value.small == 0;
+    }
+
+    bool is_negative(const Value& value){
+        return value.is_small() ? value.small < 0 : value.big->is_negative();
+    }
+
+    Value get_big_num(Input& input){
+        const NumberLiteral literal = get_num_literal(input);
+        return Value(parse_big_integer(literal.digits, literal.base));
+    }
+
+    template<typename Meter>
+    void run_bignum(const Bytecode& bytecode, Input& input, Output& output, const Limits& limits, Meter& budget){
+        const Op* const code = bytecode.code.data();
+        size_t ptr = 0;
+
+        BigContext ctx(limits);
+        bool running = true;
+
+        // Continues after the instruction at index, the FLOW_MARK jumped to or the FLOW_CALL returned to.
+        // Every transfer charges the budget, also the ones that fall through
+        budget.enter(0);
+        const auto continue_after = [&](const size_t index){
+            budget.enter(index + 1);
+            ptr = index;
+        };
+
+        while(running){
+            switch(code[ptr].type){
+                case InstructionType::STACK_PUSH:
+                    ctx.stack_push(Value(code[ptr].operand));
+                    break;
+                case InstructionType::STACK_DUP_N:
+                    ctx.stack_dup_n(static_cast<size_t>(code[ptr].operand));
+                    break;
+                case InstructionType::STACK_DUP_TOP:
+                    ctx.stack_dup_n(0);
+                    break;
+                case InstructionType::STACK_DISCARD_N:
+                    ctx.stack_discard_n(code[ptr].operand);
+                    break;
+                case InstructionType::STACK_DISCARD_TOP:
+                    ctx.stack_pop();
+                    break;
+                case InstructionType::STACK_SWAP:
+                    ctx.stack_swap_top();
+                    break;
+                case InstructionType::ARITHMETIC_ADD:
+                case InstructionType::ARITHMETIC_SUB:
+                case InstructionType::ARITHMETIC_MULTIPLICATE:
+                case InstructionType::ARITHMETIC_DIVIDE:
+                case InstructionType::ARITHMETIC_MODULO:
+                    arithmetic(ctx, code[ptr].type);
+                    break;
+                case InstructionType::HEAP_POP:
+                    ctx.heap_pop();
+                    break;
+                case InstructionType::HEAP_PUSH:
+                    ctx.heap_push();
+                    break;
+                case InstructionType::OUTPUT_CHAR:
+                    output.put(static_cast<char>(ctx.stack_pop().wrapped()));
+                    break;
+                case InstructionType::OUTPUT_NUM:{
+                        const Value value = ctx.stack_pop();
+                        if(value.is_small()){
+                            output.write_num(value.small);
+                        }
+                        else{
+                            output.write(value.big->to_string());
+                        }
+                        break;
+                    }
+                case InstructionType::INPUT_CHAR:
+                    ctx.store(Value(static_cast<long long>(get_chr(input))));
+                    break;
+                case InstructionType::INPUT_NUM:
+                    ctx.store(get_big_num(input));
+                    break;
+                case InstructionType::FLOW_MARK:
+                    break;
+                case InstructionType::FLOW_CALL:
+                    ctx.call(ptr);
+                    continue_after(code[ptr].operand);
+                    break;
+                case InstructionType::FLOW_JUMP_JMP:
+                    continue_after(code[ptr].operand);
+                    break;
+                case InstructionType::FLOW_JUMP_EZ:
+                    continue_after(is_zero(ctx.stack_pop()) ? code[ptr].operand : ptr);
+                    break;
+                case InstructionType::FLOW_JUMP_LZ:
+                    continue_after(is_negative(ctx.stack_pop()) ? code[ptr].operand : ptr);
+                    break;
+                case InstructionType::FLOW_RETURN:
+                    continue_after(ctx.ret());
+                    break;
+                case InstructionType::EXIT:
+                    running = false;
+                    break;
+                case InstructionType::UNCLEAN_EXIT:
+                    Operations::unclean_exit(code[ptr].operand);
+
+                // Superinstructions run as the sequence they replace, which raises the same exceptions
+                case InstructionType::ADD_IMM:
+                    ctx.stack_push(Value(code[ptr].operand));
+                    arithmetic(ctx, InstructionType::ARITHMETIC_ADD);
+                    break;
+                case InstructionType::SUB_IMM:
+                    ctx.stack_push(Value(code[ptr].operand));
+                    arithmetic(ctx, InstructionType::ARITHMETIC_SUB);
+                    break;
+                case InstructionType::SUB_SWAPPED:
+                    ctx.stack_swap_top();
+                    arithmetic(ctx, InstructionType::ARITHMETIC_SUB);
+                    break;
+                case InstructionType::JEZ_KEEP:
+                    continue_after(is_zero(ctx.stack_top()) ? code[ptr].operand : ptr);
+                    break;
+                case InstructionType::JLZ_KEEP:
+                    continue_after(is_negative(ctx.stack_top()) ? code[ptr].operand : ptr);
+                    break;
+                case InstructionType::LOAD_IMM_ADDR:
+                    ctx.stack_push(Value(code[ptr].operand));
+                    ctx.heap_push();
+                    break;
+                case InstructionType::STORE_IMM:
+                    ctx.heap_store_imm(code[ptr].operand);
+                    break;
+                case InstructionType::STORE_TOP_AT_IMM:
+                    ctx.heap_store_top(code[ptr].operand);
+                    break;
+                default:
+                    Operations::unknown_instruction(code[ptr].type);
+            }
+            ++ptr;
+        }
+    }
+
+    void interpret_bignum(const Bytecode& bytecode, const Prepared& prepared, Input& input, Output& output, const Limits& limits){
+        with_budget(prepared.lengths, limits, [&](auto& budget){
+            run_bignum(bytecode, input, output, limits, budget);
+        });
+    }
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "../bytecode/Bytecode.hpp"
+#include "../interpreter/Input.hpp"
+#include "../interpreter/Output.hpp"
+#include "../interpreter/Prepared.hpp"
+#include "../Options.hpp"
+
+namespace WS{
+    // Runs the bytecode with values of any size. Values that fit a long long take the same paths as in the other
+    // engines and only move to a BigInt once a result overflows. The bytecode should come from compile(..., true)
+    void interpret_bignum(const Bytecode& bytecode, const Prepared& prepared, Input& input, Output& output, const Limits& limits);
+}
@@ -0,0 +1,101 @@
+#include "Bytecode.hpp"
+
+namespace WS{
+    Bytecode::Bytecode(std::vector<Op>&& code, std::vector<SourceSpan>&& spans): code(std::move(code)), spans(std::move(spans)){}
+
+    size_t Bytecode::size() const{
+        return code.size();
+    }
+
+    bool has_target(const InstructionType::InstructionType type){
+        switch(type){
+            case InstructionType::FLOW_CALL:
+            case InstructionType::FLOW_JUMP_JMP:
+            case InstructionType::FLOW_JUMP_EZ:
+            case InstructionType::FLOW_JUMP_LZ:
+            case InstructionType::JEZ_KEEP:
+            case InstructionType::JLZ_KEEP:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    long long operand_of(const Instruction& instruction, const size_t index){
+        switch(instruction.type){
+            case InstructionType::STACK_PUSH:
+                if(std::holds_alternative<const BigInt>(*(instruction.value))){
+                    return std::get<const BigInt>(*(instruction.value)).wrapped();
+                }
+                return std::get<const long long>(*(instruction.value));
+            case InstructionType::STACK_DUP_N:
+            case InstructionType::STACK_DISCARD_N:
+                return std::get<const long long>(*(instruction.value));
+            case InstructionType::FLOW_MARK:
+                return std::get<const Label>(*(instruction.value)).id;
+            case InstructionType::FLOW_CALL:
+            case InstructionType::FLOW_JUMP_JMP:
+            case InstructionType::FLOW_JUMP_EZ:
+            case InstructionType::FLOW_JUMP_LZ:
+                return static_cast<long long>(instruction.target);
+            case InstructionType::UNCLEAN_EXIT:
+                return static_cast<long long>(index);
+            default:
+                return 0;
+        }
+    }
+
+    // Builds the literal in chunks of 62 bits: push c_n, then push 2^62; mul; push c_i; add for every lower chunk
+    void expand_literal(const BigInt& literal, std::vector<Op>& code){
+        constexpr long long RADIX = 1LL << 62;
+        const BigInt radix(RADIX);
+
+        std::vector<long long> chunks;
+        BigInt rest = literal.is_negative() ? -literal : literal;
+        while(!rest.is_zero()){
+            const long long chunk = floor_modulo(rest, radix).to_long_long();
+            chunks.push_back(literal.is_negative() ? -chunk : chunk);
+            rest = floor_divide(rest, radix);
+        }
+
+        code.push_back(Op{InstructionType::STACK_PUSH, chunks.back()});
+        for(size_t i = chunks.size() - 1; i-- > 0;){
+            code.push_back(Op{InstructionType::STACK_PUSH, RADIX});
+            code.push_back(Op{InstructionType::ARITHMETIC_MULTIPLICATE, 0});
+            code.push_back(Op{InstructionType::STACK_PUSH, chunks[i]});
+            code.push_back(Op{InstructionType::ARITHMETIC_ADD, 0});
+        }
+    }
+
+    Bytecode compile(const LinkingResult& instructions, const bool exact_literals){
+        std::vector<Op> code;
+        std::vector<SourceSpan> spans;
+        std::vector<size_t> new_index(instructions.size(), 0);
+        bool expanded = false;
+        code.reserve(instructions.size());
+        spans.reserve(instructions.size());
+
+        for(size_t i = 0; i < instructions.size(); ++i){
+            const Instruction& instruction = instructions[i];
+            new_index[i] = code.size();
+            if(exact_literals && instruction.type == InstructionType::STACK_PUSH && std::holds_alternative<const BigInt>(*(instruction.value))){
+                expand_literal(std::get<const BigInt>(*(instruction.value)), code);
+                spans.resize(code.size(), SourceSpan{instruction.from, instruction.to});
+                expanded = true;
+                continue;
+            }
+            code.push_back(Op{instruction.type, operand_of(instruction, i)});
+            spans.push_back(SourceSpan{instruction.from, instruction.to});
+        }
+
+        if(expanded){
+            for(Op& op: code){
+                if(has_target(op.type)){
+                    op.operand = static_cast<long long>(new_index[op.operand]);
+                }
+            }
+        }
+
+        return Bytecode(std::move(code), std::move(spans));
+    }
+}
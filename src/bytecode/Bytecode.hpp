@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+
+#include "../parser/Linker.hpp"
+
+namespace WS{
+    // A fixed width instruction. The operand holds the literal of STACK_PUSH / STACK_DUP_N / STACK_DISCARD_N,
+    // the resolved target index of FLOW_CALL / FLOW_JUMP_*, the label id of FLOW_MARK and the original instruction index of UNCLEAN_EXIT
+    struct Op{
+        InstructionType::InstructionType type;
+        long long operand;
+    };
+
+    struct SourceSpan{
+        size_t from;
+        size_t to;
+    };
+
+    class Bytecode{
+    public:
+        const std::vector<Op> code;
+        const std::vector<SourceSpan> spans;    // Parallel to code, only read for diagnostics
+
+        Bytecode() = delete;
+        Bytecode(std::vector<Op>&& code, std::vector<SourceSpan>&& spans);
+        Bytecode(const Bytecode& bytecode) = default;
+        Bytecode(Bytecode&& bytecode) = default;
+        Bytecode& operator=(const Bytecode&) = delete;
+        Bytecode& operator=(Bytecode&&) = delete;
+
+        size_t size() const;
+    };
+
+    // Whether the operand of the instruction is the index of another instruction
+    bool has_target(const InstructionType::InstructionType type);
+
+    // With exact_literals, STACK_PUSH literals wider than a long long become arithmetic that rebuilds them, for the bignum engine.
+    // Otherwise they wrap around to 64 bits
+    Bytecode compile(const LinkingResult& instructions, const bool exact_literals = false);
+}
@@ -0,0 +1,46 @@
+#include "Listing.hpp"
+
+namespace WS{
+    // Whether the operand is a literal worth showing
+    bool has_literal(const InstructionType::InstructionType type){
+        switch(type){
+            case InstructionType::STACK_PUSH:
+            case InstructionType::STACK_DUP_N:
+            case InstructionType::STACK_DISCARD_N:
+            case InstructionType::ADD_IMM:
+            case InstructionType::SUB_IMM:
+            case InstructionType::LOAD_IMM_ADDR:
+            case InstructionType::STORE_IMM:
+            case InstructionType::STORE_TOP_AT_IMM:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void write_instruction(const Bytecode& bytecode, const LabelTable& labels, const size_t index, std::ostream& output){
+        const Op& op = bytecode.code[index];
+        output << index << " [" << instruction_name(op.type) << ": " << bytecode.spans[index].from << '-' << bytecode.spans[index].to << ']';
+
+        if(has_literal(op.type)){
+            output << "->(" << op.operand << ')';
+        }
+        else if(op.type == InstructionType::FLOW_MARK){
+            output << "->(";
+            labels.write_name(static_cast<uint32_t>(op.operand), output);
+            output << ')';
+        }
+        else if(has_target(op.type)){
+            output << "->(";
+            labels.write_name(static_cast<uint32_t>(bytecode.code[op.operand].operand), output);
+            output << " @" << op.operand << ')';
+        }
+    }
+
+    void write_listing(const Bytecode& bytecode, const LabelTable& labels, std::ostream& output){
+        for(size_t i = 0; i < bytecode.size(); ++i){
+            write_instruction(bytecode, labels, i, output);
+            output << '\n';
+        }
+    }
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include <ostream>
+
+#include "Bytecode.hpp"
+
+namespace WS{
+    // One line per instruction, e.g. "12 [FLOW::JUMP::EZ: 272-277]->(TSN @51)": index, name, source span, then the literal,
+    // the label of a FLOW_MARK or the label and index of a target. Streams everything directly, nothing is built in between
+    void write_listing(const Bytecode& bytecode, const LabelTable& labels, std::ostream& output);
+
+    // A single line of the listing, without the newline
+    void write_instruction(const Bytecode& bytecode, const LabelTable& labels, const size_t index, std::ostream& output);
+}
@@ -0,0 +1,207 @@
+#include <string>
+
+#include "ProgramFile.hpp"
+#include "../exceptions/Exceptions.hpp"
+
+namespace WS{
+    namespace ProgramFile{
+        constexpr char MAGIC[4] = {'W', 'S', 'C', '\x1A'};
+        constexpr size_t HEADER_SIZE = 40;
+        constexpr size_t CHECKSUM_OFFSET = 32;      // Everything in front of it is covered by the checksum, as is the body
+        constexpr size_t OP_SIZE = 16;
+        constexpr size_t SPAN_SIZE = 16;
+        constexpr uint32_t KNOWN_FLAGS = Flags::EXACT_LITERALS | Flags::OPTIMIZED;
+        constexpr uint32_t TYPE_COUNT = InstructionType::STORE_TOP_AT_IMM + 1;
+
+        void put_u32(std::string& data, const uint32_t value){
+            for(int shift = 0; shift < 32; shift += 8){
+                data += static_cast<char>((value >> shift) & 0xFF);
+            }
+        }
+
+        void put_u64(std::string& data, const uint64_t value){
+            for(int shift = 0; shift < 64; shift += 8){
+                data += static_cast<char>((value >> shift) & 0xFF);
+            }
+        }
+
+        uint32_t get_u32(const char* data){
+            uint32_t value = 0;
+            for(int i = 3; i >= 0; --i){
+                value = (value << 8) | static_cast<unsigned char>(data[i]);
+            }
+            return value;
+        }
+
+        uint64_t get_u64(const char* data){
+            uint64_t value = 0;
+            for(int i = 7; i >= 0; --i){
+                value = (value << 8) | static_cast<unsigned char>(data[i]);
+            }
+            return value;
+        }
+
+        // FNV-1a over little endian 64 bit words, the tail byte by byte
+        uint64_t checksum(std::string_view data, uint64_t hash = 0xCBF29CE484222325ULL){
+            constexpr uint64_t PRIME = 0x100000001B3ULL;
+            size_t i = 0;
+            for(; i + 8 <= data.size(); i += 8){
+                hash = (hash ^ get_u64(data.data() + i)) * PRIME;
+            }
+            for(; i < data.size(); ++i){
+                hash = (hash ^ static_cast<unsigned char>(data[i])) * PRIME;
+            }
+            return hash;
+        }
+
+        // Of the header up to the checksum and the body, so flags and counts are covered as well
+        uint64_t checksum(std::string_view header, std::string_view body){
+            return checksum(body, checksum(header.substr(0, CHECKSUM_OFFSET)));
+        }
+
+        [[noreturn]] void invalid(const std::string& reason){
+            throw InvalidProgramImage("COMPILATION: Invalid program image: " + reason);
+        }
+
+        // Whether running into this instruction can never fall through to the next one
+        bool is_terminal(const InstructionType::InstructionType type){
+            switch(type){
+                case InstructionType::FLOW_JUMP_JMP:
+                case InstructionType::FLOW_RETURN:
+                case InstructionType::EXIT:
+                case InstructionType::UNCLEAN_EXIT:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        bool is_image(std::string_view data){
+            return data.size() >= sizeof(MAGIC) && data.substr(0, sizeof(MAGIC)) == std::string_view(MAGIC, sizeof(MAGIC));
+        }
+
+        void write(const Bytecode& bytecode, const LabelTable& labels, const uint32_t flags, std::ostream& output){
+            // Only the labels of marks that survived the optimizer are kept, renumbered in order of appearance
+            std::vector<uint32_t> kept;
+
+            std::string body;
+            body.reserve(bytecode.size() * (OP_SIZE + SPAN_SIZE));
+            for(const Op& op: bytecode.code){
+                long long operand = op.operand;
+                if(op.type == InstructionType::FLOW_MARK){
+                    kept.push_back(static_cast<uint32_t>(operand));
+                    operand = static_cast<long long>(kept.size() - 1);
+                }
+                put_u32(body, static_cast<uint32_t>(op.type));
+                put_u32(body, 0);
+                put_u64(body, static_cast<uint64_t>(operand));
+            }
+            for(const SourceSpan& span: bytecode.spans){
+                put_u64(body, span.from);
+                put_u64(body, span.to);
+            }
+            for(const uint32_t id: kept){
+                const std::string name = labels.name(id);
+                put_u32(body, static_cast<uint32_t>(name.size() - 1));
+                body.append(name, 0, name.size() - 1);     // Without the terminating 'N'
+            }
+
+            std::string header(MAGIC, sizeof(MAGIC));
+            put_u32(header, VERSION);
+            put_u32(header, flags);
+            put_u32(header, 0);
+            put_u64(header, bytecode.size());
+            put_u64(header, kept.size());
+            put_u64(header, checksum(header, body));
+
+            output.write(header.data(), static_cast<std::streamsize>(header.size()));
+            output.write(body.data(), static_cast<std::streamsize>(body.size()));
+        }
+
+        Image read(std::string_view data){
+            if(!is_image(data)){
+                invalid("not a .wsc file");
+            }
+            if(data.size() < HEADER_SIZE){
+                invalid("truncated header");
+            }
+
+            const uint32_t version = get_u32(data.data() + 4);
+            if(version != VERSION){
+                invalid("format version " + std::to_string(version) + ", expected " + std::to_string(VERSION));
+            }
+            const uint32_t flags = get_u32(data.data() + 8);
+            if((flags & ~KNOWN_FLAGS) != 0 || get_u32(data.data() + 12) != 0){
+                invalid("unknown flags");
+            }
+
+            const std::string_view body = data.substr(HEADER_SIZE);
+            const uint64_t op_count = get_u64(data.data() + 16);
+            const uint64_t label_count = get_u64(data.data() + 24);
+            if(checksum(data, body) != get_u64(data.data() + CHECKSUM_OFFSET)){
+                invalid("checksum mismatch");
+            }
+            if(op_count == 0 || op_count > body.size() / (OP_SIZE + SPAN_SIZE)){
+                invalid("bad instruction count");
+            }
+
+            const char* const ops = body.data();
+            const char* const spans = ops + op_count * OP_SIZE;
+            std::vector<Op> code;
+            std::vector<SourceSpan> source_spans;
+            code.reserve(op_count);
+            source_spans.reserve(op_count);
+            for(size_t i = 0; i < op_count; ++i){
+                const char* const op = ops + i * OP_SIZE;
+                const uint32_t type = get_u32(op);
+                if(type >= TYPE_COUNT || get_u32(op + 4) != 0){
+                    invalid("unknown instruction type at " + std::to_string(i));
+                }
+                code.push_back(Op{static_cast<InstructionType::InstructionType>(type), static_cast<long long>(get_u64(op + 8))});
+                source_spans.push_back(SourceSpan{get_u64(spans + i * SPAN_SIZE), get_u64(spans + i * SPAN_SIZE + 8)});
+            }
+
+            LabelTable labels;
+            size_t position = op_count * (OP_SIZE + SPAN_SIZE);
+            labels.reserve(body.size() - position);
+            for(uint64_t id = 0; id < label_count; ++id){
+                if(body.size() - position < 4 || body.size() - position - 4 < get_u32(body.data() + position)){
+                    invalid("truncated label table");
+                }
+                const uint32_t length = get_u32(body.data() + position);
+                position += 4;
+
+                LabelTable::Node node = LabelTable::ROOT;
+                for(const char bit: body.substr(position, length)){
+                    if(bit != 'S' && bit != 'T'){
+                        invalid("malformed label " + std::to_string(id));
+                    }
+                    node = labels.step(node, bit == 'T');
+                }
+                if(labels.intern(node) != id){
+                    invalid("duplicate label " + std::to_string(id));
+                }
+                position += length;
+            }
+            if(position != body.size()){
+                invalid("trailing data");
+            }
+
+            // Engines jump to target + 1 and return to call + 1 without bounds checks, both have to stay inside the code
+            for(size_t i = 0; i < code.size(); ++i){
+                const Op& op = code[i];
+                if(has_target(op.type) && (op.operand < 0 || static_cast<uint64_t>(op.operand) >= op_count || code[op.operand].type != InstructionType::FLOW_MARK)){
+                    invalid("jump target out of range at " + std::to_string(i));
+                }
+                if(op.type == InstructionType::FLOW_MARK && (op.operand < 0 || static_cast<uint64_t>(op.operand) >= label_count)){
+                    invalid("label out of range at " + std::to_string(i));
+                }
+            }
+            if(!is_terminal(code.back().type)){
+                invalid("the last instruction falls through");
+            }
+
+            return Image{Bytecode(std::move(code), std::move(source_spans)), std::move(labels), flags};
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+#include "Bytecode.hpp"
+
+namespace WS{
+    // The .wsc image of a compiled program, so running it again skips the whole front end. All fields are little endian:
+    //
+    //   header    "WSC" 0x1A, u32 version, u32 flags, u32 reserved (0), u64 op count, u64 label count, u64 checksum of the header before it and everything after the header
+    //   ops       op count times u32 type, u32 reserved (0), i64 operand
+    //   spans     op count times u64 from, u64 to
+    //   labels    label count times u32 length, then that many 'S' / 'T' bits, in id order
+    //
+    // The loader validates everything the engines rely on, so a damaged or foreign image is a compile error and never undefined behaviour
+    namespace ProgramFile{
+        constexpr uint32_t VERSION = 2;     // 1 didn't cover the header with the checksum
+
+        namespace Flags{
+            enum Flags: uint32_t{
+                EXACT_LITERALS = 1,     // Compiled for the bignum engine, wide STACK_PUSH literals weren't wrapped
+                OPTIMIZED = 2,          // Went through the optimizer, contains superinstructions
+            };
+        }
+
+        struct Image{
+            Bytecode bytecode;
+            LabelTable labels;
+            uint32_t flags;
+        };
+
+        // Whether data starts with the image magic, text sources don't contain its 0x1A byte
+        bool is_image(std::string_view data);
+
+        void write(const Bytecode& bytecode, const LabelTable& labels, const uint32_t flags, std::ostream& output);
+
+        // Raises InvalidProgramImage if data isn't a complete, intact image of this version
+        Image read(std::string_view data);
+    }
+}
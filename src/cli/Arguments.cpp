@@ -0,0 +1,133 @@
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+
+#include "Arguments.hpp"
+
+namespace WS{
+    namespace CLI{
+        const char USAGE[] =
+            "USAGE: whitespace [<Flag>...] <file.ws|file.wsc> [<Input>...]\n"
+            "Flags:\n"
+            "  --engine=switch|threaded|jit|bignum\n"
+            "                                  Select the execution engine (default: threaded)\n"
+            "  --no-optimize                   Run the bytecode exactly as parsed, without folding or superinstructions\n"
+            "  --emit-c=<file.cpp>             Translate the program to standalone C++ instead of running it\n"
+            "  --compile=<file.wsc>            Save the program as a precompiled .wsc image instead of running it\n"
+            "  --dump-ir                       List the bytecode that would run, one instruction per line, instead of running it\n"
+            "  --profile                       Run on the switch engine and report where the time went to stderr afterwards\n"
+            "  --profile-folded=<file>         Like --profile, also saves the time per call stack for flamegraph.pl or speedscope\n"
+            "  --stdin                         Stream the program input from stdin instead of taking <Input>...\n"
+            "  --max-call-depth=<n>            Fail with a runtime error once calls nest deeper than n (default: 16777216)\n"
+            "  --max-stack-depth=<n>           Fail with a runtime error once more than n values are on the stack\n"
+            "  --max-heap-cells=<n>            Fail with a runtime error once more than n heap addresses were stored to\n"
+            "  --max-instructions=<n>          Fail with a runtime error instead of executing more than n instructions\n"
+            "  --time-limit=<ms>               Fail with a runtime error once the program ran for longer than ms milliseconds\n";
+
+        Engine::Engine parse_engine(const std::string_view name){
+            if(name == "switch"){
+                return Engine::SWITCH;
+            }
+            if(name == "threaded"){
+                return Engine::THREADED;
+            }
+            if(name == "jit"){
+                return Engine::JIT;
+            }
+            if(name == "bignum"){
+                return Engine::BIGNUM;
+            }
+            throw std::invalid_argument(std::string("Unknown engine ") + std::string(name));
+        }
+
+        size_t parse_limit(const std::string_view flag, const std::string_view value){
+            size_t limit = 0;
+            const std::from_chars_result parsed = std::from_chars(value.data(), value.data() + value.size(), limit);
+            if(value.empty() || parsed.ec != std::errc() || parsed.ptr != value.data() + value.size() || limit == 0){
+                throw std::invalid_argument(std::string(flag) + " needs a positive number");
+            }
+            return limit;
+        }
+
+        Arguments parse_arguments(int argc, char const *argv[]){
+            Arguments result;
+            int i = 1;
+
+            for(; i < argc; ++i){
+                const std::string_view arg = argv[i];
+                if(arg.substr(0, 2) != "--"){
+                    break;
+                }
+
+                if(arg.substr(0, 9) == "--engine="){
+                    result.options.engine = parse_engine(arg.substr(9));
+                }
+                else if(arg == "--no-optimize"){
+                    result.options.optimize = false;
+                }
+                else if(arg.substr(0, 9) == "--emit-c="){
+                    result.emit_c_path = arg.substr(9);
+                    if(result.emit_c_path.empty()){
+                        throw std::invalid_argument("--emit-c needs an output file");
+                    }
+                }
+                else if(arg.substr(0, 10) == "--compile="){
+                    result.compile_path = arg.substr(10);
+                    if(result.compile_path.empty()){
+                        throw std::invalid_argument("--compile needs an output file");
+                    }
+                }
+                else if(arg.substr(0, 17) == "--max-call-depth="){
+                    result.options.limits.call_depth = parse_limit("--max-call-depth", arg.substr(17));
+                }
+                else if(arg.substr(0, 18) == "--max-stack-depth="){
+                    result.options.limits.stack_depth = parse_limit("--max-stack-depth", arg.substr(18));
+                }
+                else if(arg.substr(0, 17) == "--max-heap-cells="){
+                    result.options.limits.heap_cells = parse_limit("--max-heap-cells", arg.substr(17));
+                }
+                else if(arg.substr(0, 19) == "--max-instructions="){
+                    result.options.limits.instructions = parse_limit("--max-instructions", arg.substr(19));
+                }
+                else if(arg.substr(0, 13) == "--time-limit="){
+                    result.options.limits.milliseconds = parse_limit("--time-limit", arg.substr(13));
+                }
+                else if(arg == "--dump-ir"){
+                    result.dump_ir = true;
+                }
+                else if(arg == "--profile"){
+                    result.profile = true;
+                }
+                else if(arg.substr(0, 17) == "--profile-folded="){
+                    result.folded_path = arg.substr(17);
+                    if(result.folded_path.empty()){
+                        throw std::invalid_argument("--profile-folded needs an output file");
+                    }
+                    result.profile = true;
+                }
+                else if(arg == "--stdin"){
+                    result.read_stdin = true;
+                }
+                else{
+                    throw std::invalid_argument(std::string("Unknown flag ") + std::string(arg));
+                }
+            }
+
+            if(result.profile && result.options.engine == Engine::BIGNUM){
+                throw std::invalid_argument("--profile runs on the switch engine and can't be combined with --engine=bignum");
+            }
+            if(i == argc){
+                throw std::invalid_argument("Missing program path");
+            }
+            result.path = argv[i++];
+
+            for(; i < argc; ++i){
+                result.inputs.push_back(argv[i]);
+            }
+            if(result.read_stdin && !result.inputs.empty()){
+                throw std::invalid_argument("--stdin doesn't take inputs after the program path");
+            }
+            return result;
+        }
+    }
+}
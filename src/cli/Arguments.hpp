@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../Options.hpp"
+
+namespace WS{
+    namespace CLI{
+        struct Arguments{
+            std::string path;
+            std::vector<std::string> inputs;
+            Options options;
+            std::string emit_c_path;    // Empty unless the program should be translated instead of run
+            std::string compile_path;   // Empty unless the program should be saved as a .wsc image instead of run
+            bool dump_ir = false;       // List the bytecode instead of running it
+            bool profile = false;       // Run under the profiler and report the hot spots to stderr
+            std::string folded_path;    // Empty unless the profiled call stacks should be saved as well, implies profile
+            bool read_stdin = false;    // Program input comes from stdin instead of the inputs
+        };
+
+        // "switch", "threaded", "jit" or "bignum", throws std::invalid_argument for anything else
+        Engine::Engine parse_engine(const std::string_view name);
+
+        // Flags have to come before the program path, everything after it is program input
+        Arguments parse_arguments(int argc, char const *argv[]);
+
+        extern const char USAGE[];
+    }
+}
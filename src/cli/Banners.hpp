@@ -0,0 +1,15 @@
+#pragma once
+
+// Section headers the CLI prints around a run, also printed by programs compiled from --emit-c output
+namespace WS{
+    namespace CLI{
+        namespace Banners{
+            constexpr char RESULT[] = "~~~~~RESULT~~~~~\n";
+            constexpr char RUNTIME_EXCEPTION[] = "~~~RUNTIME EXCEPTION~~~\n";
+            constexpr char COMPILATION_ERROR[] = "~~~COMPILATION ERROR~~~\n";
+            constexpr char CPP_EXCEPTION[] = "~~~C++ EXCEPTION~~~\n";
+            constexpr char UNKNOWN_ERROR[] = "~~~UNKNOWN ERROR~~~\n";
+            constexpr char PROFILE[] = "~~~~~PROFILE~~~~~\n";
+        }
+    }
+}
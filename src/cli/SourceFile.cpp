@@ -0,0 +1,82 @@
+#include <stdexcept>
+
+#include "SourceFile.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define WS_MMAP_AVAILABLE 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <sstream>
+#endif
+
+namespace WS{
+    namespace CLI{
+#ifdef WS_MMAP_AVAILABLE
+        SourceFile::SourceFile(const std::string& path){
+            const int fd = open(path.c_str(), O_RDONLY);
+            if(fd < 0){
+                throw std::runtime_error("Couldn't open file " + path);
+            }
+
+            struct stat info;
+            if(fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0){
+                void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if(address != MAP_FAILED){
+                    madvise(address, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+                    mapping = static_cast<const char*>(address);
+                    mapped_length = static_cast<size_t>(info.st_size);
+                    close(fd);
+                    return;
+                }
+            }
+
+            // Empty files can't be mapped and pipes have no size, read them instead
+            char chunk[1 << 16];
+            while(true){
+                const ssize_t count = read(fd, chunk, sizeof(chunk));
+                if(count < 0){
+                    close(fd);
+                    throw std::runtime_error("Couldn't read file");
+                }
+                if(count == 0){
+                    break;
+                }
+                buffer.append(chunk, static_cast<size_t>(count));
+            }
+            close(fd);
+        }
+
+        SourceFile::~SourceFile(){
+            if(mapping != nullptr){
+                munmap(const_cast<char*>(mapping), mapped_length);
+            }
+        }
+#else
+        SourceFile::SourceFile(const std::string& path){
+            std::ifstream file = std::ifstream(path, std::ios::binary);
+            if(!file.is_open()){
+                throw std::runtime_error("Couldn't open file " + path);
+            }
+            std::stringstream content;
+            content << file.rdbuf();
+            if(file.bad()){
+                throw std::runtime_error("Couldn't read file");
+            }
+            buffer = content.str();
+        }
+
+        SourceFile::~SourceFile(){}
+#endif
+
+        std::string_view SourceFile::content() const{
+            if(mapping != nullptr){
+                return std::string_view(mapping, mapped_length);
+            }
+            return buffer;
+        }
+    }
+}
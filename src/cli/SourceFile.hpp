@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+namespace WS{
+    namespace CLI{
+        // A program file mapped read-only into memory, read into a buffer where mapping isn't possible (pipes, non-unix hosts)
+        class SourceFile{
+        private:
+            const char* mapping = nullptr;
+            size_t mapped_length = 0;
+            std::string buffer;
+
+        public:
+            // Throws std::runtime_error if the file can't be opened or read
+            SourceFile(const std::string& path);
+            SourceFile(const SourceFile&) = delete;
+            SourceFile& operator=(const SourceFile&) = delete;
+            ~SourceFile();
+
+            // Only valid while the SourceFile lives
+            std::string_view content() const;
+        };
+    }
+}
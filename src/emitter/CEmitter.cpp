@@ -0,0 +1,353 @@
+#include <climits>
+#include <set>
+#include <string>
+
+#include "CEmitter.hpp"
+#include "../cli/Banners.hpp"
+#include "../exceptions/Messages.hpp"
+
+namespace WS{
+    std::string literal(const char* text){
+        std::string result = "\"";
+        for(; *text != '\0'; ++text){
+            switch(*text){
+                case '"':
+                    result += "\\\"";
+                    break;
+                case '\\':
+                    result += "\\\\";
+                    break;
+                case '\n':
+                    result += "\\n";
+                    break;
+                default:
+                    result += *text;
+            }
+        }
+        return result + '"';
+    }
+
+    std::string integer(const long long value){
+        if(value == LLONG_MIN){
+            return "(-9223372036854775807LL - 1)";   // The negation of 9223372036854775808 would overflow
+        }
+        return std::to_string(value) + "LL";
+    }
+
+    // Mirrors Context, Operations and get_chr / get_num, with the message texts filled in from Messages
+    void emit_prelude(std::ostream& output, const size_t max_call_depth){
+        output <<
+            "#include <cmath>\n"
+            "#include <cstddef>\n"
+            "#include <iostream>\n"
+            "#include <sstream>\n"
+            "#include <stdexcept>\n"
+            "#include <string>\n"
+            "#include <unordered_map>\n"
+            "#include <vector>\n"
+            "\n"
+            "namespace{\n"
+            "    struct RuntimeException: std::runtime_error{\n"
+            "        using std::runtime_error::runtime_error;\n"
+            "    };\n"
+            "\n"
+            "    std::vector<long long> value_stack;\n"
+            "    std::vector<std::size_t> call_stack;\n"
+            "    constexpr std::size_t max_call_depth = " << max_call_depth << "ULL;\n"
+            "    std::unordered_map<long long, long long> heap;\n"
+            "    std::stringstream input;\n"
+            "    bool printed = false;   // Whether the program wrote anything, the error banners only start a new line after output\n"
+            "\n"
+            "    [[maybe_unused]] void require(const std::size_t size){\n"
+            "        if(value_stack.size() < size){\n"
+            "            throw RuntimeException(" << literal(Messages::VALUE_STACK_TOO_SMALL_PREFIX) << " + std::to_string(size) + " << literal(Messages::VALUE_STACK_TOO_SMALL_INFIX) << " + std::to_string(value_stack.size()));\n"
+            "        }\n"
+            "    }\n"
+            "\n"
+            "    [[maybe_unused]] long long pop(){\n"
+            "        if(value_stack.empty()){\n"
+            "            throw RuntimeException(" << literal(Messages::VALUE_STACK_EMPTY) << ");\n"
+            "        }\n"
+            "        const long long value = value_stack.back();\n"
+            "        value_stack.pop_back();\n"
+            "        return value;\n"
+            "    }\n"
+            "\n"
+            "    [[maybe_unused]] void push(const long long value){\n"
+            "        value_stack.push_back(value);\n"
+            "    }\n"
+            "\n"
+            "    [[maybe_unused]] void dup_n(const long long n){\n"
+            "        require(n + 1);\n"
+            "        push(value_stack[value_stack.size() - 1 - n]);\n"
+            "    }\n"
+            "\n"
+            "    [[maybe_unused]] void discard_n(const long long n){\n"
+            "        if(!value_stack.empty()){\n"
+            "            const long long top = value_stack.back();\n"
+            "            value_stack.pop_back();\n"
+            "            for(long long i = 0; (i < n || n < 0) && !value_stack.empty(); ++i){\n"
+            "                value_stack.pop_back();\n"
+            "            }\n"
+            "            value_stack.push_back(top);\n"
+            "        }\n"
+            "    }\n"
+            "\n"
+            "    [[maybe_unused]] void swap(){\n"
+            "        require(2);\n"
+            "        const long long a = pop();\n"
+            "        const long long b = pop();\n"
+            "        push(a);\n"
+            "        push(b);\n"
+            "    }\n"
+            "\n"
+            "    [[maybe_unused]] void divide(){\n"
+            "        const long long a = pop();\n"
+            "        if(a == 0){\n"
+            "            throw RuntimeException(" << literal(Messages::DIVISION_BY_ZERO) << ");\n"
+            "        }\n"
+            "        const long long b = pop();\n"
+            "        push(std::floor(static_cast<long double>(b) / a));\n"
+            "    }\n"
+            "\n"
+            "    [[maybe_unused]] void modulo(){\n"
+            "        const long long a = pop();\n"
+            "        if(a == 0){\n"
+            "            throw RuntimeException(" << literal(Messages::DIVISION_BY_ZERO) << ");\n"
+            "        }\n"
+            "        const long long b = pop();\n"
+            "        push(b - a*std::floor(static_cast<long double>(b) / a));\n"
+            "    }\n"
+            "\n"
+            "    [[maybe_unused]] void store(const long long value){\n"
+            "        const long long addr = pop();\n"
+            "        heap.insert_or_assign(addr, value);\n"
+            "    }\n"
+            "\n"
+            "    [[maybe_unused]] void heap_pop(){\n"
+            "        require(2);\n"
+            "        const long long value = pop();\n"
+            "        store(value);\n"
+            "    }\n"
+            "\n"
+            "    [[maybe_unused]] void heap_push(){\n"
+            "        const long long addr = pop();\n"
+            "        if(heap.count(addr) == 0){\n"
+            "            throw RuntimeException(" << literal(Messages::UNDEFINED_HEAP_PREFIX) << " + std::to_string(addr) + " << literal(Messages::UNDEFINED_HEAP_SUFFIX) << ");\n"
+            "        }\n"
+            "        push(heap[addr]);\n"
+            "    }\n"
+            "\n"
+            "    [[maybe_unused]] char get_chr(){\n"
+            "        const char inp = input.get();\n"
+            "        if(input.fail()){\n"
+            "            throw RuntimeException(" << literal(Messages::EOF_IN_INPUT) << ");\n"
+            "        }\n"
+            "        return inp;\n"
+            "    }\n"
+            "\n"
+            "    [[maybe_unused]] long long get_num(){\n"
+            "        std::string buf;\n"
+            "        std::getline(input, buf);\n"
+            "        if(buf.size() == 0){\n"
+            "            throw RuntimeException(" << literal(Messages::EOF_IN_INPUT) << ");\n"
+            "        }\n"
+            "        if(buf[0] == '0'){\n"
+            "            if(buf.size() == 1){\n"
+            "                return 0;\n"
+            "            }\n"
+            "            switch(buf[1]){\n"
+            "                case 'x':\n"
+            "                    if(buf.size() == 2) throw RuntimeException(" << literal(Messages::EMPTY_HEXADECIMAL) << ");\n"
+            "                    return std::stoll(buf.substr(2), 0, 16);\n"
+            "                case 'b':\n"
+            "                    if(buf.size() == 2) throw RuntimeException(" << literal(Messages::EMPTY_BINARY) << ");\n"
+            "                    return std::stoll(buf.substr(2), 0, 2);\n"
+            "                default:\n"
+            "                    return std::stoll(buf.substr(1), 0, 8);\n"
+            "            }\n"
+            "        }\n"
+            "        return std::stoll(buf);\n"
+            "    }\n"
+            "\n"
+            "    [[maybe_unused]] void call(const std::size_t site){\n"
+            "        if(call_stack.size() >= max_call_depth){\n"
+            "            throw RuntimeException(" << literal(Messages::CALL_STACK_OVERFLOW_PREFIX) << " + std::to_string(max_call_depth));\n"
+            "        }\n"
+            "        call_stack.push_back(site);\n"
+            "    }\n"
+            "\n"
+            "    [[maybe_unused]] std::size_t ret(){\n"
+            "        if(call_stack.empty()){\n"
+            "            throw RuntimeException(" << literal(Messages::CALL_STACK_EMPTY) << ");\n"
+            "        }\n"
+            "        const std::size_t site = call_stack.back();\n"
+            "        call_stack.pop_back();\n"
+            "        return site;\n"
+            "    }\n"
+            "\n"
+            "    [[maybe_unused]] [[noreturn]] void unclean_exit(const long long index){\n"
+            "        throw RuntimeException(" << literal(Messages::UNCLEAN_EXIT_PREFIX) << " + std::to_string(index) + " << literal(Messages::UNCLEAN_EXIT_SUFFIX) << ");\n"
+            "    }\n"
+            "\n";
+    }
+
+    void emit_instruction(const Op& op, const size_t index, std::ostream& output){
+        output << "        ";
+        switch(op.type){
+            case InstructionType::STACK_PUSH:
+                output << "push(" << integer(op.operand) << ");";
+                break;
+            case InstructionType::STACK_DUP_N:
+                output << "dup_n(" << integer(op.operand) << ");";
+                break;
+            case InstructionType::STACK_DUP_TOP:
+                output << "dup_n(0);";
+                break;
+            case InstructionType::STACK_DISCARD_N:
+                output << "discard_n(" << integer(op.operand) << ");";
+                break;
+            case InstructionType::STACK_DISCARD_TOP:
+                output << "pop();";
+                break;
+            case InstructionType::STACK_SWAP:
+                output << "swap();";
+                break;
+            case InstructionType::ARITHMETIC_ADD:
+                output << "{ const long long a = pop(); const long long b = pop(); push(b + a); }";
+                break;
+            case InstructionType::ARITHMETIC_SUB:
+                output << "{ const long long a = pop(); const long long b = pop(); push(b - a); }";
+                break;
+            case InstructionType::ARITHMETIC_MULTIPLICATE:
+                output << "{ const long long a = pop(); const long long b = pop(); push(b * a); }";
+                break;
+            case InstructionType::ARITHMETIC_DIVIDE:
+                output << "divide();";
+                break;
+            case InstructionType::ARITHMETIC_MODULO:
+                output << "modulo();";
+                break;
+            case InstructionType::HEAP_POP:
+                output << "heap_pop();";
+                break;
+            case InstructionType::HEAP_PUSH:
+                output << "heap_push();";
+                break;
+            case InstructionType::OUTPUT_CHAR:
+                output << "std::cout.put(static_cast<char>(pop())); printed = true;";
+                break;
+            case InstructionType::OUTPUT_NUM:
+                output << "std::cout << pop(); printed = true;";
+                break;
+            case InstructionType::INPUT_CHAR:
+                output << "store(static_cast<long long>(get_chr()));";
+                break;
+            case InstructionType::INPUT_NUM:
+                output << "store(get_num());";
+                break;
+            case InstructionType::FLOW_MARK:
+                output << ';';
+                break;
+            case InstructionType::FLOW_CALL:
+                output << "call(" << index << "); goto L" << op.operand << ';';
+                break;
+            case InstructionType::FLOW_JUMP_JMP:
+                output << "goto L" << op.operand << ';';
+                break;
+            case InstructionType::FLOW_JUMP_EZ:
+                output << "if(pop() == 0) goto L" << op.operand << ';';
+                break;
+            case InstructionType::FLOW_JUMP_LZ:
+                output << "if(pop() < 0) goto L" << op.operand << ';';
+                break;
+            case InstructionType::FLOW_RETURN:
+                output << "goto RETURN;";
+                break;
+            case InstructionType::EXIT:
+                output << "return;";
+                break;
+            case InstructionType::UNCLEAN_EXIT:
+                output << "unclean_exit(" << integer(op.operand) << ");";
+                break;
+            default:
+                output << "throw RuntimeException(\"RUNTIME: Unknown Instruction type " << op.type << " found\");";
+                break;
+        }
+    }
+
+    void emit_c(const Bytecode& bytecode, std::ostream& output, const size_t max_call_depth){
+        std::set<size_t> targets;
+        std::set<size_t> call_sites;
+        bool returns = false;
+        for(size_t i = 0; i < bytecode.size(); ++i){
+            switch(bytecode.code[i].type){
+                case InstructionType::FLOW_RETURN:
+                    returns = true;
+                    break;
+                case InstructionType::FLOW_CALL:
+                    call_sites.insert(i);
+                    [[fallthrough]];
+                case InstructionType::FLOW_JUMP_JMP:
+                case InstructionType::FLOW_JUMP_EZ:
+                case InstructionType::FLOW_JUMP_LZ:
+                    targets.insert(static_cast<size_t>(bytecode.code[i].operand));
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        output << "// Generated by whitespace --emit-c\n";
+        emit_prelude(output, max_call_depth);
+
+        output << "    void run(){\n";
+        for(size_t i = 0; i < bytecode.size(); ++i){
+            if(targets.count(i) != 0){
+                output << "    L" << i << ":\n";
+            }
+            emit_instruction(bytecode.code[i], i, output);
+            output << "    // [" << instruction_name(bytecode.code[i].type) << ": " << range(bytecode.spans[i].from, bytecode.spans[i].to) << "]\n";
+            if(call_sites.count(i) != 0){
+                output << "    R" << i << ":\n";
+            }
+        }
+
+        if(returns){
+            output << "    RETURN:\n"
+                      "        switch(ret()){\n";
+            for(const size_t site: call_sites){
+                output << "            case " << site << ": goto R" << site << ";\n";
+            }
+            output << "            default: return;\n"
+                      "        }\n";
+        }
+        output << "    }\n"
+                  "}\n"
+                  "\n"
+                  "int main(int argc, char const *argv[]){\n"
+                  "    std::ios::sync_with_stdio(false);\n"
+                  "    std::string arguments;\n"
+                  "    for(int i = 1; i < argc; ++i){\n"
+                  "        arguments += std::string(argv[i]) + '\\n';\n"
+                  "    }\n"
+                  "    input.str(arguments);\n"
+                  "\n"
+                  "    try{\n"
+                  "        std::cout << " << literal(CLI::Banners::RESULT) << ";\n"
+                  "        run();\n"
+                  "        std::cout << '\\n';\n"
+                  "    }\n"
+                  "    catch(const RuntimeException& ex){\n"
+                  "        std::cout << (printed ? \"\\n\" : \"\") << " << literal(CLI::Banners::RUNTIME_EXCEPTION) << " << ex.what() << '\\n';\n"
+                  "    }\n"
+                  "    catch(const std::exception& ex){\n"
+                  "        std::cout << (printed ? \"\\n\" : \"\") << " << literal(CLI::Banners::CPP_EXCEPTION) << " << ex.what() << '\\n';\n"
+                  "    }\n"
+                  "    catch(...){\n"
+                  "        std::cout << (printed ? \"\\n\" : \"\") << " << literal(CLI::Banners::UNKNOWN_ERROR) << " << '\\n';\n"
+                  "    }\n"
+                  "    return 0;\n"
+                  "}\n";
+    }
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <ostream>
+
+#include "../Options.hpp"
+#include "../bytecode/Bytecode.hpp"
+
+namespace WS{
+    // Writes a standalone C++17 translation unit that behaves like `whitespace <program> [<Input>...]`:
+    // same inputs, same output, same runtime error texts. Every branch target becomes a goto label.
+    // Calls nesting deeper than max_call_depth fail like they do under Limits::call_depth
+    void emit_c(const Bytecode& bytecode, std::ostream& output, size_t max_call_depth = Limits::DEFAULT_CALL_DEPTH);
+}
@@ -29,9 +29,11 @@ namespace WS{
 
     WS_COMPILETIME_EXCEPTION_DEFINITION(NumberFormatError)
     WS_COMPILETIME_EXCEPTION_DEFINITION(LabelAlreadyExistsError)
+    WS_COMPILETIME_EXCEPTION_DEFINITION(LabelDoesntExistError)
     WS_COMPILETIME_EXCEPTION_DEFINITION(UnexpectedToken)
     WS_COMPILETIME_EXCEPTION_DEFINITION(UnknownTokenTypeFound)
     WS_COMPILETIME_EXCEPTION_DEFINITION(UnexpectedEOF)
+    WS_COMPILETIME_EXCEPTION_DEFINITION(InvalidProgramImage)
 
     //Runtime errors
 
@@ -40,12 +42,18 @@ namespace WS{
 
     WS_RUNTIME_EXCEPTION_DEFINITION(ValueStackEmpty, StackSizeException)
     WS_RUNTIME_EXCEPTION_DEFINITION(CallStackEmpty, StackSizeException)
+    WS_RUNTIME_EXCEPTION_DEFINITION(CallStackOverflow, StackSizeException)
     WS_RUNTIME_EXCEPTION_DEFINITION(ValueStackTooSmall, StackSizeException)
+    WS_RUNTIME_EXCEPTION_DEFINITION(ValueStackOverflow, StackSizeException)
 
     WS_RUNTIME_EXCEPTION_DEFINITION(LabelDoesntExist, WhitespaceRuntimeException)
 
     WS_RUNTIME_EXCEPTION_DEFINITION(UnknownInstructionTypeFound, WhitespaceRuntimeException)
     WS_RUNTIME_EXCEPTION_DEFINITION(UndefinedHeapAccess, WhitespaceRuntimeException)
+    WS_RUNTIME_EXCEPTION_DEFINITION(HeapLimitExceeded, WhitespaceRuntimeException)
+
+    WS_RUNTIME_EXCEPTION_DEFINITION(InstructionLimitExceeded, WhitespaceRuntimeException)
+    WS_RUNTIME_EXCEPTION_DEFINITION(TimeLimitExceeded, WhitespaceRuntimeException)
 
     WS_RUNTIME_EXCEPTION_DEFINITION(UncleanExit, WhitespaceRuntimeException)
     WS_RUNTIME_EXCEPTION_DEFINITION(EofInInput, WhitespaceRuntimeException)
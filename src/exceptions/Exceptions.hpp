@@ -36,9 +36,11 @@ namespace WS{
     // Compile time errors
     WS_EXCEPTION_DECLARATION(NumberFormatError, WhitespaceCompileError);
     WS_EXCEPTION_DECLARATION(LabelAlreadyExistsError, WhitespaceCompileError);
+    WS_EXCEPTION_DECLARATION(LabelDoesntExistError, WhitespaceCompileError);
     WS_EXCEPTION_DECLARATION(UnexpectedToken, WhitespaceCompileError);
     WS_EXCEPTION_DECLARATION(UnknownTokenTypeFound, WhitespaceCompileError);
     WS_EXCEPTION_DECLARATION(UnexpectedEOF, WhitespaceCompileError);
+    WS_EXCEPTION_DECLARATION(InvalidProgramImage, WhitespaceCompileError);
 
     // Runtime exceptions
     WS_EXCEPTION_DECLARATION(RuntimeNumberFormatException, WhitespaceRuntimeException);
@@ -46,12 +48,18 @@ namespace WS{
     
     WS_EXCEPTION_DECLARATION(ValueStackEmpty, StackSizeException);
     WS_EXCEPTION_DECLARATION(CallStackEmpty, StackSizeException);
+    WS_EXCEPTION_DECLARATION(CallStackOverflow, StackSizeException);
     WS_EXCEPTION_DECLARATION(ValueStackTooSmall, StackSizeException);
+    WS_EXCEPTION_DECLARATION(ValueStackOverflow, StackSizeException);
 
     WS_EXCEPTION_DECLARATION(LabelDoesntExist, WhitespaceRuntimeException);
     
     WS_EXCEPTION_DECLARATION(UnknownInstructionTypeFound, WhitespaceRuntimeException);
     WS_EXCEPTION_DECLARATION(UndefinedHeapAccess, WhitespaceRuntimeException);
+    WS_EXCEPTION_DECLARATION(HeapLimitExceeded, WhitespaceRuntimeException);
+
+    WS_EXCEPTION_DECLARATION(InstructionLimitExceeded, WhitespaceRuntimeException);
+    WS_EXCEPTION_DECLARATION(TimeLimitExceeded, WhitespaceRuntimeException);
 
     WS_EXCEPTION_DECLARATION(UncleanExit, WhitespaceRuntimeException);
     WS_EXCEPTION_DECLARATION(EofInInput, WhitespaceRuntimeException);
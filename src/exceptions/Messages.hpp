@@ -0,0 +1,28 @@
+#pragma once
+
+// Texts of the runtime exceptions, shared by the engines and by the code emitted with --emit-c.
+// Split messages are joined as PREFIX + value + SUFFIX
+namespace WS{
+    namespace Messages{
+        constexpr char VALUE_STACK_EMPTY[] = "RUNTIME: value Stack is empty";
+        constexpr char CALL_STACK_EMPTY[] = "RUNTIME: callstack is empty";
+        constexpr char CALL_STACK_OVERFLOW_PREFIX[] = "RUNTIME: callstack exceeded its maximum depth of ";
+        constexpr char VALUE_STACK_OVERFLOW_PREFIX[] = "RUNTIME: value Stack exceeded its maximum depth of ";
+        constexpr char HEAP_LIMIT_PREFIX[] = "RUNTIME: Heap exceeded its maximum of ";
+        constexpr char HEAP_LIMIT_SUFFIX[] = " cells";
+        constexpr char INSTRUCTION_LIMIT_PREFIX[] = "RUNTIME: program exceeded its budget of ";
+        constexpr char INSTRUCTION_LIMIT_SUFFIX[] = " instructions";
+        constexpr char TIME_LIMIT_PREFIX[] = "RUNTIME: program exceeded its time limit of ";
+        constexpr char TIME_LIMIT_SUFFIX[] = " ms";
+        constexpr char VALUE_STACK_TOO_SMALL_PREFIX[] = "RUNTIME: expected Value stack to be at least ";
+        constexpr char VALUE_STACK_TOO_SMALL_INFIX[] = ", but is only ";
+        constexpr char UNDEFINED_HEAP_PREFIX[] = "RUNTIME: Heap addr ";
+        constexpr char UNDEFINED_HEAP_SUFFIX[] = " is undefined";
+        constexpr char DIVISION_BY_ZERO[] = "RUNTIME: Division by 0";
+        constexpr char EOF_IN_INPUT[] = "RUNTIME: sudden EOF in Input";
+        constexpr char EMPTY_HEXADECIMAL[] = "RUNTIME: '0x' is not a valid number!";
+        constexpr char EMPTY_BINARY[] = "RUNTIME: '0b' is not a valid number!";
+        constexpr char UNCLEAN_EXIT_PREFIX[] = "RUNTIME: Instruction Pointer [";
+        constexpr char UNCLEAN_EXIT_SUFFIX[] = "] ran past last Instruction";
+    }
+}
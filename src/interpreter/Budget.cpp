@@ -0,0 +1,50 @@
+#include <algorithm>
+#include <climits>
+#include <string>
+
+#include "Budget.hpp"
+#include "../exceptions/Exceptions.hpp"
+#include "../exceptions/Messages.hpp"
+#include "../optimizer/ControlFlow.hpp"
+
+namespace WS{
+    std::vector<size_t> stretch_lengths(const Bytecode& bytecode){
+        std::vector<size_t> lengths(bytecode.size() + 1, 0);
+        for(size_t i = bytecode.size(); i-- > 0;){
+            lengths[i] = 1 + (ends_block(bytecode.code[i].type) ? 0 : lengths[i + 1]);
+        }
+        return lengths;
+    }
+
+    std::chrono::steady_clock::time_point deadline_after(const size_t milliseconds){
+        if(milliseconds == Limits::UNLIMITED){
+            return std::chrono::steady_clock::time_point::max();
+        }
+        return std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+    }
+
+    Budget::Budget(const std::vector<size_t>& lengths, const Limits& limits):
+        fuel(0), lengths(lengths.data()), instructions(limits.instructions), remaining(limits.instructions),
+        milliseconds(limits.milliseconds), deadline(deadline_after(limits.milliseconds)){
+        grant();
+    }
+
+    void Budget::grant(){
+        const size_t slice = milliseconds == Limits::UNLIMITED ? LLONG_MAX : TIME_SLICE;
+        const size_t granted = std::min(remaining, slice);
+        remaining -= granted;
+        fuel = static_cast<long long>(granted);
+    }
+
+    void Budget::refuel(){
+        const size_t overdraft = static_cast<size_t>(-fuel);
+        if(overdraft > remaining){
+            throw InstructionLimitExceeded(Messages::INSTRUCTION_LIMIT_PREFIX + std::to_string(instructions) + Messages::INSTRUCTION_LIMIT_SUFFIX);
+        }
+        remaining -= overdraft;
+        if(milliseconds != Limits::UNLIMITED && std::chrono::steady_clock::now() >= deadline){
+            throw TimeLimitExceeded(Messages::TIME_LIMIT_PREFIX + std::to_string(milliseconds) + Messages::TIME_LIMIT_SUFFIX);
+        }
+        grant();
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <chrono>
+#include <vector>
+
+#include "../Options.hpp"
+#include "../bytecode/Bytecode.hpp"
+
+namespace WS{
+    // For every instruction, how many instructions run from it up to and including the next jump, call, return or exit.
+    // Has one extra entry for the end of the code, which costs nothing
+    std::vector<size_t> stretch_lengths(const Bytecode& bytecode);
+
+    // Meters a run against Limits::instructions and Limits::milliseconds. Whenever control enters code other than by
+    // falling through, the engines charge everything up to the next transfer at once, so a run stops right before the
+    // stretch that would take it past its budget and costs a subtraction per transfer instead of a check per instruction.
+    // The clock is only read every TIME_SLICE instructions
+    class Budget{
+    public:
+        static constexpr long long TIME_SLICE = 1 << 16;
+
+        long long fuel;     // Left to charge before refuel has to look at the limits, compiled code charges it directly
+
+    private:
+        const size_t* const lengths;    // Of stretch_lengths, which has to outlive the Budget
+        const size_t instructions;
+        size_t remaining;       // Of instructions, not handed out as fuel yet
+        const size_t milliseconds;
+        const std::chrono::steady_clock::time_point deadline;
+
+        void grant();
+
+    public:
+        Budget(const std::vector<size_t>& lengths, const Limits& limits);
+        Budget(const Budget&) = delete;
+        Budget& operator=(const Budget&) = delete;
+
+        // Charges the stretch starting at target
+        void enter(const size_t target){
+            fuel -= static_cast<long long>(lengths[target]);
+            if(fuel < 0){
+                refuel();
+            }
+        }
+
+        // Called once fuel dropped below zero, raises InstructionLimitExceeded or TimeLimitExceeded or refills fuel
+        void refuel();
+    };
+
+    // Stands in for a Budget when the limits don't need metering, the engines are instantiated for either
+    struct Unmetered{
+        void enter(const size_t){}
+    };
+
+    // Calls run with a Budget over lengths if limits.metered() and with Unmetered otherwise
+    template<typename Run>
+    void with_budget(const std::vector<size_t>& lengths, const Limits& limits, Run run){
+        if(limits.metered()){
+            Budget budget(lengths, limits);
+            run(budget);
+        }
+        else{
+            Unmetered unmetered;
+            run(unmetered);
+        }
+    }
+}
@@ -1,6 +1,15 @@
+#include <algorithm>
+
 #include "Context.hpp"
+#include "../exceptions/Messages.hpp"
 
 namespace WS{
+    constexpr size_t INITIAL_CALL_STACK_CAPACITY = 1024;
+
+    Context::Context(const Limits& limits): value_stack(limits.stack_depth), max_call_depth(limits.call_depth), heap(limits.heap_cells){
+        call_stack.reserve(std::min(max_call_depth, INITIAL_CALL_STACK_CAPACITY));
+    }
+
     bool Context::stack_empty(){
         return value_stack.empty();
     }
@@ -11,26 +20,40 @@ namespace WS{
 
     void Context::throw_if_value_stack_empty(){
         if(stack_empty()){
-            throw ValueStackEmpty("RUNTIME: value Stack is empty");
+            throw ValueStackEmpty(Messages::VALUE_STACK_EMPTY);
         }
     }
 
     void Context::throw_if_call_stack_empty(){
         if(callstack_empty()){
-            throw CallStackEmpty("RUNTIME: callstack is empty");
+            throw CallStackEmpty(Messages::CALL_STACK_EMPTY);
         }
     }
 
     void Context::throw_if_value_stack_too_small(const size_t size){
         if(value_stack.size() < size){
-            throw ValueStackTooSmall(std::string("RUNTIME: expected Value stack to be at least ") + std::to_string(size) + ", but is only " + std::to_string(value_stack.size()));
+            throw_value_stack_too_small(size, value_stack.size());
         }
     }
 
-    void Context::throw_if_heap_doesnt_contain_address(long long addr){
-        if(heap.count(addr) == 0){
-            throw UndefinedHeapAccess(std::string("RUNTIME: Heap addr ") + std::to_string(addr) + " is undefined");
+    void Context::throw_value_stack_too_small(const size_t size, const size_t actual){
+        throw ValueStackTooSmall(Messages::VALUE_STACK_TOO_SMALL_PREFIX + std::to_string(size) + Messages::VALUE_STACK_TOO_SMALL_INFIX + std::to_string(actual));
+    }
+
+    void Context::throw_undefined_heap_access(const long long addr){
+        throw UndefinedHeapAccess(Messages::UNDEFINED_HEAP_PREFIX + std::to_string(addr) + Messages::UNDEFINED_HEAP_SUFFIX);
+    }
+
+    long long Context::heap_get(const long long addr){
+        const long long* const cell = heap.find(addr);
+        if(cell == nullptr){
+            throw_undefined_heap_access(addr);
         }
+        return *cell;
+    }
+
+    void Context::heap_set(const long long addr, const long long value){
+        heap.store(addr, value);
     }
 
     long long Context::stack_pop_num(){
@@ -90,13 +113,16 @@ namespace WS{
     }
 
     void Context::call(const size_t return_address){
-        call_stack.push(return_address);
+        if(call_stack.size() >= max_call_depth){
+            throw CallStackOverflow(Messages::CALL_STACK_OVERFLOW_PREFIX + std::to_string(max_call_depth));
+        }
+        call_stack.push_back(return_address);
     }
 
     size_t Context::ret(){
         throw_if_call_stack_empty();
-        const long long addr = call_stack.top();
-        call_stack.pop();
+        const size_t addr = call_stack.back();
+        call_stack.pop_back();
         return addr;
     }
 
@@ -104,23 +130,65 @@ namespace WS{
         throw_if_value_stack_too_small(2);
         const long long val = stack_pop_num();
         const long long addr = stack_pop_num();
-        heap.insert_or_assign(addr, val);
+        heap.store(addr, val);
     }
 
     void Context::heap_push(){
         const long long addr = stack_pop_num();
-        throw_if_heap_doesnt_contain_address(addr);
-        
-        value_stack.push_back(heap[addr]);
+        value_stack.push_back(heap_get(addr));
     }
 
     void Context::store_num(const long long num){
         const long long addr = stack_pop_num();
-        heap.insert_or_assign(addr, num);
+        heap.store(addr, num);
     }
 
     void Context::store_char(const char c){
         store_num(static_cast<long long>(c));
     }
 
+    void Context::stack_add_imm(const long long num){
+        throw_if_value_stack_empty();
+        value_stack.top[-1] += num;
+    }
+
+    void Context::stack_sub_imm(const long long num){
+        throw_if_value_stack_empty();
+        value_stack.top[-1] -= num;
+    }
+
+    void Context::stack_sub_swapped(){
+        throw_if_value_stack_too_small(2);
+        const long long val = stack_pop_num();
+        value_stack.top[-1] = val - value_stack.top[-1];
+    }
+
+    long long Context::stack_peek_dup(){
+        throw_if_value_stack_too_small(1);
+        return value_stack.back();
+    }
+
+    void Context::heap_load(const long long addr){
+        value_stack.push_back(heap_get(addr));
+    }
+
+    // The replaced STACK_PUSH would already be on the stack when HEAP_POP / STACK_SWAP check its size
+    void Context::heap_store_imm(const long long num){
+        if(stack_empty()){
+            throw_value_stack_too_small(2, 1);
+        }
+        store_num(num);
+    }
+
+    void Context::heap_store_top(const long long addr){
+        if(stack_empty()){
+            throw_value_stack_too_small(2, 1);
+        }
+        heap.store(addr, stack_pop_num());
+    }
+
+    ValueStack& Context::values(){
+        return value_stack;
+    }
+
 }
\ No newline at end of file
@@ -1,21 +1,27 @@
 #pragma once
 
-#include <stack>
-#include "../parser/Parser.hpp"
+#include <vector>
+
+#include "Heap.hpp"
+#include "ValueStack.hpp"
+#include "../Options.hpp"
+#include "../bytecode/Bytecode.hpp"
 
 namespace WS{
     class Context{
     private:
-        std::vector<long long> value_stack;
-        std::stack<size_t> call_stack;
-        std::unordered_map<long long, long long> heap;
+        ValueStack value_stack;
+        std::vector<size_t> call_stack;     // Contiguous, reserved up front and never deeper than max_call_depth
+        size_t max_call_depth;
+        Heap heap;
 
         void throw_if_value_stack_empty();
         void throw_if_call_stack_empty();
         void throw_if_value_stack_too_small(const size_t size);
-        void throw_if_heap_doesnt_contain_address(long long addr);
+        [[noreturn]] void throw_value_stack_too_small(const size_t size, const size_t actual);
+        [[noreturn]] void throw_undefined_heap_access(const long long addr);
     public:
-        Context() = default;
+        Context(const Limits& limits = Limits());
         Context(const Context& context) = default;
         Context(Context&& context) = default;
         Context& operator=(const Context& constext) = default;
@@ -46,5 +52,21 @@ namespace WS{
 
         void store_num(const long long num);
         void store_char(const char c);
+
+        // Superinstructions, each raises exactly what the sequence it replaces would
+        void stack_add_imm(const long long num);
+        void stack_sub_imm(const long long num);
+        void stack_sub_swapped();
+        long long stack_peek_dup();
+        void heap_load(const long long addr);
+        void heap_store_imm(const long long num);
+        void heap_store_top(const long long addr);
+
+        // Raises UndefinedHeapAccess like HEAP_PUSH
+        long long heap_get(const long long addr);
+        void heap_set(const long long addr, const long long value);
+
+        // Raw access for compiled code, which keeps the top of the stack in a register between calls into the Context
+        ValueStack& values();
     };
 }
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include <string>
+
+#include "Heap.hpp"
+#include "../exceptions/Exceptions.hpp"
+#include "../exceptions/Messages.hpp"
+
+namespace WS{
+    Heap::Heap(const size_t limit): limit(limit){}
+
+    Heap::Heap(const Heap& heap): pages(heap.pages.size()), sparse(heap.sparse), cells(heap.cells), limit(heap.limit){
+        for(size_t i = 0; i < pages.size(); ++i){
+            if(heap.pages[i] != nullptr){
+                pages[i] = std::make_unique<Page>(*heap.pages[i]);
+            }
+        }
+    }
+
+    Heap& Heap::operator=(Heap heap) noexcept{
+        std::swap(pages, heap.pages);
+        std::swap(sparse, heap.sparse);
+        std::swap(cells, heap.cells);
+        std::swap(limit, heap.limit);
+        return *this;
+    }
+
+    Heap::Page& Heap::allocate_page(const long long addr){
+        const size_t index = static_cast<size_t>(addr) >> PAGE_BITS;
+        if(index >= pages.size()){
+            pages.resize(index + 1);
+        }
+        pages[index] = std::make_unique<Page>();    // Value-initialized, so every cell starts undefined
+        return *pages[index];
+    }
+
+    void Heap::store_sparse(const long long addr, const long long value){
+        const auto cell = sparse.find(addr);
+        if(cell != sparse.end()){
+            cell->second = value;
+            return;
+        }
+        count_cell();
+        sparse.emplace(addr, value);
+    }
+
+    void Heap::count_cell(){
+        if(cells == limit){
+            throw HeapLimitExceeded(Messages::HEAP_LIMIT_PREFIX + std::to_string(limit) + Messages::HEAP_LIMIT_SUFFIX);
+        }
+        ++cells;
+    }
+
+    const long long* Heap::find_sparse(const long long addr) const{
+        const auto cell = sparse.find(addr);
+        return cell == sparse.end() ? nullptr : &cell->second;
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace WS{
+    // Heap cells addressed directly through a page table, pages are allocated on their first store.
+    // Negative addresses and those past the page table go to a hash map instead.
+    // It performs no checks, Context is responsible for raising the runtime exceptions. The one exception is the cell limit,
+    // looked at only when a store defines a new cell, which raises HeapLimitExceeded
+    class Heap{
+    public:
+        static constexpr size_t PAGE_BITS = 12;
+        static constexpr size_t PAGE_SIZE = size_t(1) << PAGE_BITS;
+        static constexpr size_t MAX_PAGES = size_t(1) << 16;       // Keeps the page table itself at most 512 KiB
+
+    private:
+        struct Page{
+            long long cells[PAGE_SIZE];
+            std::bitset<PAGE_SIZE> defined;
+        };
+
+        std::vector<std::unique_ptr<Page>> pages;
+        std::unordered_map<long long, long long> sparse;
+        size_t cells = 0;       // Defined so far, in pages and sparse
+        size_t limit;
+
+        static bool is_direct(const long long addr){
+            return static_cast<unsigned long long>(addr) < MAX_PAGES * PAGE_SIZE;
+        }
+
+        Page* page_of(const long long addr) const{
+            const size_t index = static_cast<size_t>(addr) >> PAGE_BITS;
+            return index < pages.size() ? pages[index].get() : nullptr;
+        }
+
+        Page& allocate_page(const long long addr);
+        const long long* find_sparse(const long long addr) const;
+        void store_sparse(const long long addr, const long long value);
+        void count_cell();
+
+    public:
+        Heap(const size_t limit = SIZE_MAX);
+        Heap(const Heap& heap);
+        Heap(Heap&& heap) noexcept = default;
+        Heap& operator=(Heap heap) noexcept;
+
+        // The cell at addr, nullptr if nothing was stored there yet
+        const long long* find(const long long addr) const{
+            if(!is_direct(addr)){
+                return find_sparse(addr);
+            }
+            const Page* const page = page_of(addr);
+            const size_t offset = static_cast<size_t>(addr) & (PAGE_SIZE - 1);
+            if(page == nullptr || !page->defined[offset]){
+                return nullptr;
+            }
+            return &page->cells[offset];
+        }
+
+        void store(const long long addr, const long long value){
+            if(!is_direct(addr)){
+                store_sparse(addr, value);
+                return;
+            }
+            Page* page = page_of(addr);
+            if(page == nullptr){
+                page = &allocate_page(addr);
+            }
+            const size_t offset = static_cast<size_t>(addr) & (PAGE_SIZE - 1);
+            if(!page->defined[offset]){
+                count_cell();
+                page->defined[offset] = true;
+            }
+            page->cells[offset] = value;
+        }
+    };
+}
@@ -0,0 +1,74 @@
+#include <cerrno>
+#include <cstring>
+
+#include "Input.hpp"
+#include "Output.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define WS_POSIX_READ 1
+#endif
+
+namespace WS{
+    std::string_view Input::get_line(){
+        if(cursor == end && !refill()){
+            return std::string_view();
+        }
+
+        const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        if(newline != nullptr){
+            const std::string_view result(cursor, newline - cursor);   // The common case, straight from the buffer
+            cursor = newline + 1;
+            return result;
+        }
+
+        line.assign(cursor, end);
+        cursor = end;
+        while(refill()){
+            newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+            if(newline != nullptr){
+                line.append(cursor, newline);
+                cursor = newline + 1;
+                break;
+            }
+            line.append(cursor, end);
+            cursor = end;
+        }
+        return line;
+    }
+
+    StringInput::StringInput(std::string content): content(std::move(content)){}
+
+    bool StringInput::refill(){
+        if(handed_out || content.empty()){
+            return false;
+        }
+        handed_out = true;
+        cursor = content.data();
+        end = cursor + content.size();
+        return true;
+    }
+
+    FileInput::FileInput(std::FILE* file, const size_t buffer_size): file(file), buffer(buffer_size){}
+
+    bool FileInput::refill(){
+        if(tied != nullptr){
+            tied->flush();
+        }
+#ifdef WS_POSIX_READ
+        // read returns whatever is available, so interactive input isn't held back until the buffer is full
+        ssize_t count;
+        do{
+            count = read(fileno(file), buffer.data(), buffer.size());
+        }while(count < 0 && errno == EINTR);
+#else
+        const size_t count = std::fread(buffer.data(), 1, buffer.size(), file);
+#endif
+        if(count <= 0){
+            return false;
+        }
+        cursor = buffer.data();
+        end = cursor + count;
+        return true;
+    }
+}
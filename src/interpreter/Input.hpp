@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace WS{
+    class Output;
+
+    // What INPUT_CHAR / INPUT_NUM read from. Reads are served from [cursor, end), subclasses only provide the next chunk
+    class Input{
+    private:
+        std::string line;       // Holds lines that span a refill, keeps its capacity between calls
+
+    protected:
+        const char* cursor = nullptr;
+        const char* end = nullptr;
+        Output* tied = nullptr;
+
+        // Points [cursor, end) at the next chunk, false once the input is exhausted
+        virtual bool refill() = 0;
+
+    public:
+        Input() = default;
+        Input(const Input&) = delete;
+        Input& operator=(const Input&) = delete;
+        virtual ~Input() = default;
+
+        // Has output flushed before every read that may block, so prompts show up before the program waits for an answer.
+        // Like std::istream::tie, nullptr unties it
+        void tie(Output* output){
+            tied = output;
+        }
+
+        // Next character, EOF once the input is exhausted
+        int get(){
+            if(cursor == end && !refill()){
+                return EOF;
+            }
+            return static_cast<unsigned char>(*cursor++);
+        }
+
+        // Everything up to the next '\n', which is consumed but not part of it. Empty if the input is exhausted.
+        // Only valid until the next read
+        std::string_view get_line();
+    };
+
+    // Input that is fully known up front, like the joined commandline arguments
+    class StringInput: public Input{
+    private:
+        const std::string content;
+        bool handed_out = false;
+
+    protected:
+        bool refill() override;
+
+    public:
+        StringInput(std::string content);
+    };
+
+    // Input read incrementally from a file, e.g. stdin, so memory stays the same however long it is
+    class FileInput: public Input{
+    private:
+        std::FILE* const file;
+        std::vector<char> buffer;
+
+    protected:
+        bool refill() override;
+
+    public:
+        static constexpr size_t DEFAULT_BUFFER_SIZE = 1 << 20;
+
+        // Doesn't take ownership of file
+        FileInput(std::FILE* file, const size_t buffer_size = DEFAULT_BUFFER_SIZE);
+    };
+}
@@ -1,79 +1,252 @@
-#include <cmath>
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <stdexcept>
 
 #include "Interpreter.hpp"
+#include "Operations.hpp"
+#include "StackDepth.hpp"
+#include "Budget.hpp"
+#include "../exceptions/Messages.hpp"
+#include "../jit/Jit.hpp"
+#include "../bignum/Bignum.hpp"
 
 
 namespace WS{
     void throw_if_input_eof(const bool bad){
         if(bad){
-            throw EofInInput("RUNTIME: sudden EOF in Input");
+            throw EofInInput(Messages::EOF_IN_INPUT);
         }
     }
 
-    char get_chr(std::stringstream& input){
-        const char inp = input.get();
-        throw_if_input_eof(input.fail());
-        return inp;
+    char get_chr(Input& input){
+        const int inp = input.get();
+        throw_if_input_eof(inp == EOF);
+        return static_cast<char>(inp);
     }
-    long long get_num(std::stringstream& input){
-        std::string buf;
-        std::getline(input, buf);
+    // Parses like std::stoll(text, 0, base) and raises what it would, without copying the text
+    long long parse_integer(std::string_view text, const int base){
+        size_t i = 0;
+        while(i < text.size() && std::isspace(static_cast<unsigned char>(text[i]))){
+            ++i;
+        }
 
-        if(buf.size() == 0){
-            throw EofInInput("RUNTIME: sudden EOF in Input");
+        bool negative = false;
+        if(i < text.size() && (text[i] == '+' || text[i] == '-')){
+            negative = text[i] == '-';
+            ++i;
+        }
+        if(base == 16 && i + 2 < text.size() && text[i] == '0' && (text[i + 1] == 'x' || text[i + 1] == 'X') && std::isxdigit(static_cast<unsigned char>(text[i + 2]))){
+            i += 2;
         }
 
-        if(buf[0] == '0'){
-            if(buf.size() == 1){
-                return 0;
+        unsigned long long magnitude = 0;
+        const char* const first = text.data() + i;
+        const std::from_chars_result parsed = std::from_chars(first, text.data() + text.size(), magnitude, base);
+        if(parsed.ptr == first){
+            throw std::invalid_argument("stoll");
+        }
+
+        const unsigned long long limit = static_cast<unsigned long long>(LLONG_MAX) + (negative ? 1 : 0);
+        if(parsed.ec == std::errc::result_out_of_range || magnitude > limit){
+            throw std::out_of_range("stoll");
+        }
+        return negative ? static_cast<long long>(0ULL - magnitude) : static_cast<long long>(magnitude);
+    }
+
+    NumberLiteral get_num_literal(Input& input){
+        const std::string_view line = input.get_line();
+
+        if(line.size() == 0){
+            throw EofInInput(Messages::EOF_IN_INPUT);
+        }
+
+        if(line[0] == '0'){
+            if(line.size() == 1){
+                return NumberLiteral{line, 10};
             }
-            switch(buf[1]){
+            switch(line[1]){
                 case 'x':
-                    if(buf.size() == 2) throw RuntimeNumberFormatException("RUNTIME: '0x' is not a valid number!");
-                    return std::stoll(buf.substr(2), 0, 16);
+                    if(line.size() == 2) throw RuntimeNumberFormatException(Messages::EMPTY_HEXADECIMAL);
+                    return NumberLiteral{line.substr(2), 16};
                 case 'b':
-                    if(buf.size() == 2) throw RuntimeNumberFormatException("RUNTIME: '0b' is not a valid number!");
-                    return std::stoll(buf.substr(2), 0, 2);
+                    if(line.size() == 2) throw RuntimeNumberFormatException(Messages::EMPTY_BINARY);
+                    return NumberLiteral{line.substr(2), 2};
                 default:
-                    return std::stoll(buf.substr(1), 0, 8);
+                    return NumberLiteral{line.substr(1), 8};
             }
         }
-        throw_if_input_eof(input.fail());
-        return std::stoll(buf);
+        return NumberLiteral{line, 10};
     }
 
-    void throw_if_label_doesnt_exist(const std::unordered_map<WS::Label, size_t, WS::LabelHash>& labels, const Label& label){
-        if(labels.count(label) == 0){
-            throw LabelDoesntExist(std::string("RUNTIME: Label ") + std::string(label) + " doesn't exist");
-        }
+    long long get_num(Input& input){
+        const NumberLiteral literal = get_num_literal(input);
+        return parse_integer(literal.digits, literal.base);
     }
 
 
-    std::string interpret(const ParsingResult info, std::stringstream input){
-        auto [instructions, labels] = info;
+    // Tracers see every instruction before it runs and every call and return after it succeeded (see Profiler),
+    // the hooks are inlined away for NoTracer so the plain loop pays nothing
+    struct NoTracer{
+        void step(const size_t){}
+        void call(const size_t){}
+        void ret(){}
+    };
+
+    struct InstructionCounter{
+        unsigned long long count = 0;
+
+        void step(const size_t){
+            ++count;
+        }
+        void call(const size_t){}
+        void ret(){}
+    };
+
+    template<typename Tracer, typename Meter>
+    void run_switch(const Bytecode& bytecode, const size_t* const required, Input& input, Output& output, const Limits& limits, Tracer& tracer, Meter& budget){
+        const Op* const code = bytecode.code.data();
         size_t ptr = 0;
 
-        Context ctx;
-        long long regA = 0;
-        long long regB = 0;
+        budget.enter(0);
+        Context ctx(limits);
+        ValueStack& stack = ctx.values();
         bool running = true;
+        bool verified = required[0] == 0;
 
-        std::string result;
+        // Continues at target, the stack and the budget are checked once here for everything up to the next transfer
+        const auto enter = [&](const size_t target){
+            budget.enter(target);
+            ptr = target - 1;
+            verified = stack.size() >= required[target];
+        };
 
-    
         while(running){
-            switch(instructions[ptr].type){
+            tracer.step(ptr);
+            if(verified){
+                switch(code[ptr].type){
+                    case InstructionType::STACK_PUSH:
+                        stack.push_back(code[ptr].operand);
+                        break;
+                    case InstructionType::STACK_DUP_N:
+                        Operations::Unchecked::dup_n(stack, code[ptr].operand);
+                        break;
+                    case InstructionType::STACK_DUP_TOP:
+                        Operations::Unchecked::dup_n(stack, 0);
+                        break;
+                    case InstructionType::STACK_DISCARD_N:
+                        ctx.stack_discard_n(code[ptr].operand);
+                        break;
+                    case InstructionType::STACK_DISCARD_TOP:
+                        stack.pop_back();
+                        break;
+                    case InstructionType::STACK_SWAP:
+                        Operations::Unchecked::swap(stack);
+                        break;
+                    case InstructionType::ARITHMETIC_ADD:
+                        Operations::Unchecked::add(stack);
+                        break;
+                    case InstructionType::ARITHMETIC_SUB:
+                        Operations::Unchecked::sub(stack);
+                        break;
+                    case InstructionType::ARITHMETIC_MULTIPLICATE:
+                        Operations::Unchecked::multiplicate(stack);
+                        break;
+                    case InstructionType::ARITHMETIC_DIVIDE:
+                        Operations::Unchecked::divide(stack);
+                        break;
+                    case InstructionType::ARITHMETIC_MODULO:
+                        Operations::Unchecked::modulo(stack);
+                        break;
+                    case InstructionType::HEAP_POP:
+                        Operations::Unchecked::heap_pop(ctx);
+                        break;
+                    case InstructionType::HEAP_PUSH:
+                        Operations::Unchecked::heap_push(ctx);
+                        break;
+                    case InstructionType::OUTPUT_CHAR:
+                        Operations::Unchecked::output_char(stack, output);
+                        break;
+                    case InstructionType::OUTPUT_NUM:
+                        Operations::Unchecked::output_num(stack, output);
+                        break;
+                    case InstructionType::INPUT_CHAR:
+                        Operations::Unchecked::input_char(ctx, input);
+                        break;
+                    case InstructionType::INPUT_NUM:
+                        Operations::Unchecked::input_num(ctx, input);
+                        break;
+                    case InstructionType::FLOW_MARK:
+                        break;
+                    case InstructionType::FLOW_CALL:
+                        ctx.call(ptr);
+                        tracer.call(code[ptr].operand);
+                        enter(code[ptr].operand + 1);
+                        break;
+                    case InstructionType::FLOW_JUMP_JMP:
+                        enter(code[ptr].operand + 1);
+                        break;
+                    case InstructionType::FLOW_JUMP_EZ:
+                        enter(Operations::Unchecked::pop(stack) == 0 ? code[ptr].operand + 1 : ptr + 1);
+                        break;
+                    case InstructionType::FLOW_JUMP_LZ:
+                        enter(Operations::Unchecked::pop(stack) < 0 ? code[ptr].operand + 1 : ptr + 1);
+                        break;
+                    case InstructionType::FLOW_RETURN:{
+                        const size_t back = ctx.ret();
+                        tracer.ret();
+                        enter(back + 1);
+                        break;
+                    }
+                    case InstructionType::EXIT:
+                        running = false;
+                        break;
+                    case InstructionType::UNCLEAN_EXIT:
+                        Operations::unclean_exit(code[ptr].operand);
+                    case InstructionType::ADD_IMM:
+                        stack.top[-1] += code[ptr].operand;
+                        break;
+                    case InstructionType::SUB_IMM:
+                        stack.top[-1] -= code[ptr].operand;
+                        break;
+                    case InstructionType::SUB_SWAPPED:
+                        Operations::Unchecked::sub_swapped(stack);
+                        break;
+                    case InstructionType::JEZ_KEEP:
+                        enter(stack.back() == 0 ? code[ptr].operand + 1 : ptr + 1);
+                        break;
+                    case InstructionType::JLZ_KEEP:
+                        enter(stack.back() < 0 ? code[ptr].operand + 1 : ptr + 1);
+                        break;
+                    case InstructionType::LOAD_IMM_ADDR:
+                        ctx.heap_load(code[ptr].operand);
+                        break;
+                    case InstructionType::STORE_IMM:
+                        Operations::Unchecked::store_num(ctx, code[ptr].operand);
+                        break;
+                    case InstructionType::STORE_TOP_AT_IMM:
+                        ctx.heap_set(code[ptr].operand, Operations::Unchecked::pop(stack));
+                        break;
+                    default:
+                        Operations::unknown_instruction(code[ptr].type);
+                }
+                ++ptr;
+                continue;
+            }
+
+            // The stack may be too shallow somewhere before the next transfer, so every instruction checks for itself
+            switch(code[ptr].type){
                 case InstructionType::STACK_PUSH:
-                    ctx.stack_push_num(std::get<const long long>(*(instructions[ptr].value)));
+                    ctx.stack_push_num(code[ptr].operand);
                     break;
                 case InstructionType::STACK_DUP_N:
-                    ctx.stack_dup_n(static_cast<size_t>(std::get<const long long>(*(instructions[ptr].value))));
+                    ctx.stack_dup_n(static_cast<size_t>(code[ptr].operand));
                     break;
                 case InstructionType::STACK_DUP_TOP:
                     ctx.stack_dup_top();
                     break;
                 case InstructionType::STACK_DISCARD_N:
-                    ctx.stack_discard_n(std::get<const long long>(*(instructions[ptr].value)));
+                    ctx.stack_discard_n(code[ptr].operand);
                     break;
                 case InstructionType::STACK_DISCARD_TOP:
                     ctx.stack_discard_top();
@@ -82,35 +255,19 @@ namespace WS{
                     ctx.stack_swap_top();
                     break;
                 case InstructionType::ARITHMETIC_ADD:
-                    regA = ctx.stack_pop_num();
-                    regB = ctx.stack_pop_num();
-                    ctx.stack_push_num(regB + regA);
+                    Operations::add(ctx);
                     break;
                 case InstructionType::ARITHMETIC_SUB:
-                    regA = ctx.stack_pop_num();
-                    regB = ctx.stack_pop_num();
-                    ctx.stack_push_num(regB - regA);
+                    Operations::sub(ctx);
                     break;
                 case InstructionType::ARITHMETIC_MULTIPLICATE:
-                    regA = ctx.stack_pop_num();
-                    regB = ctx.stack_pop_num();
-                    ctx.stack_push_num(regB * regA);
+                    Operations::multiplicate(ctx);
                     break;
                 case InstructionType::ARITHMETIC_DIVIDE:
-                    regA = ctx.stack_pop_num();
-                    if(regA == 0){
-                        throw DivideByZeroException("RUNTIME: Division by 0");
-                    }
-                    regB = ctx.stack_pop_num();
-                    ctx.stack_push_num(std::floor(static_cast<long double>(regB) / regA));
+                    Operations::divide(ctx);
                     break;
-                case InstructionType::ARITHMETIC_MODULO:{
-                        regA = ctx.stack_pop_num();
-                        if(regA == 0) throw DivideByZeroException("RUNTIME: Division by 0");
-                        regB = ctx.stack_pop_num();
-
-                        ctx.stack_push_num(regB - regA*std::floor(static_cast<long double>(regB) / regA));
-                    }
+                case InstructionType::ARITHMETIC_MODULO:
+                    Operations::modulo(ctx);
                     break;
                 case InstructionType::HEAP_POP:
                     ctx.heap_pop();
@@ -119,62 +276,164 @@ namespace WS{
                     ctx.heap_push();
                     break;
                 case InstructionType::OUTPUT_CHAR:
-                    result += ctx.stack_pop_char();
+                    Operations::output_char(ctx, output);
                     break;
                 case InstructionType::OUTPUT_NUM:
-                    result += std::to_string(ctx.stack_pop_num());
+                    Operations::output_num(ctx, output);
                     break;
                 case InstructionType::INPUT_CHAR:
-                    ctx.store_char(get_chr(input));
+                    Operations::input_char(ctx, input);
                     break;
                 case InstructionType::INPUT_NUM:
-                    ctx.store_num(get_num(input));
+                    Operations::input_num(ctx, input);
                     break;
                 case InstructionType::FLOW_MARK:
                     break;
-                case InstructionType::FLOW_CALL:{
-                        const Label label = std::get<const Label>(*(instructions[ptr].value));
-                        throw_if_label_doesnt_exist(labels, label);
-                        ctx.call(ptr);
-                        ptr = labels.at(label);
-                    }
+                case InstructionType::FLOW_CALL:
+                    ctx.call(ptr);
+                    tracer.call(code[ptr].operand);
+                    enter(code[ptr].operand + 1);
                     break;
-                case InstructionType::FLOW_JUMP_JMP:{
-                    const Label label = std::get<const Label>(*(instructions[ptr].value));
-                        throw_if_label_doesnt_exist(labels, label);
-                        ptr = labels.at(label);
-                    }
+                case InstructionType::FLOW_JUMP_JMP:
+                    enter(code[ptr].operand + 1);
                     break;
-                case InstructionType::FLOW_JUMP_EZ:{
-                        const Label label = std::get<const Label>(*(instructions[ptr].value));
-                        if(ctx.stack_pop_num() == 0){
-                            throw_if_label_doesnt_exist(labels, label);
-                            ptr = labels.at(label);
-                        }
-                    }
+                case InstructionType::FLOW_JUMP_EZ:
+                    enter(ctx.stack_pop_num() == 0 ? code[ptr].operand + 1 : ptr + 1);
                     break;
-                case InstructionType::FLOW_JUMP_LZ:{
-                        const Label label = std::get<const Label>(*(instructions[ptr].value));
-                        if(ctx.stack_pop_num() < 0){
-                            throw_if_label_doesnt_exist(labels, label);
-                            ptr = labels.at(label);
-                        }
-                    }
+                case InstructionType::FLOW_JUMP_LZ:
+                    enter(ctx.stack_pop_num() < 0 ? code[ptr].operand + 1 : ptr + 1);
                     break;
-                case InstructionType::FLOW_RETURN:
-                    ptr = ctx.ret();
+                case InstructionType::FLOW_RETURN:{
+                    const size_t back = ctx.ret();
+                    tracer.ret();
+                    enter(back + 1);
                     break;
+                }
                 case InstructionType::EXIT:
                     running = false;
                     break;
                 case InstructionType::UNCLEAN_EXIT:
-                    throw UncleanExit(std::string("RUNTIME: Instruction Pointer [") + std::to_string(ptr) + "] ran past last Instruction");
+                    Operations::unclean_exit(code[ptr].operand);
+                case InstructionType::ADD_IMM:
+                    ctx.stack_add_imm(code[ptr].operand);
+                    break;
+                case InstructionType::SUB_IMM:
+                    ctx.stack_sub_imm(code[ptr].operand);
+                    break;
+                case InstructionType::SUB_SWAPPED:
+                    ctx.stack_sub_swapped();
+                    break;
+                case InstructionType::JEZ_KEEP:
+                    enter(ctx.stack_peek_dup() == 0 ? code[ptr].operand + 1 : ptr + 1);
+                    break;
+                case InstructionType::JLZ_KEEP:
+                    enter(ctx.stack_peek_dup() < 0 ? code[ptr].operand + 1 : ptr + 1);
+                    break;
+                case InstructionType::LOAD_IMM_ADDR:
+                    ctx.heap_load(code[ptr].operand);
+                    break;
+                case InstructionType::STORE_IMM:
+                    ctx.heap_store_imm(code[ptr].operand);
+                    break;
+                case InstructionType::STORE_TOP_AT_IMM:
+                    ctx.heap_store_top(code[ptr].operand);
+                    break;
                 default:
-                    throw UnknownInstructionTypeFound("RUNTIME: Unknown Instruction type " + std::to_string(instructions[ptr].type) + " found");
+                    Operations::unknown_instruction(code[ptr].type);
             }
             ++ptr;
         }
+    }
+
+    // Meters the run only if the limits ask for it, see with_budget
+    template<typename Tracer>
+    void run_switch(const Bytecode& bytecode, const Prepared& prepared, Input& input, Output& output, const Limits& limits, Tracer& tracer){
+        with_budget(prepared.lengths, limits, [&](auto& budget){
+            run_switch(bytecode, prepared.required.data(), input, output, limits, tracer, budget);
+        });
+    }
+
+    void interpret_switch(const Bytecode& bytecode, const Prepared& prepared, Input& input, Output& output, const Limits& limits){
+        NoTracer tracer;
+        run_switch(bytecode, prepared, input, output, limits, tracer);
+    }
+
+    unsigned long long count_instructions(const Bytecode& bytecode, Input& input, Output& output, const Limits& limits){
+        InstructionCounter counter;
+        try{
+            run_switch(bytecode, prepare(bytecode, Engine::SWITCH, limits), input, output, limits, counter);
+        }
+        catch(...){
+            output.flush();
+            throw;
+        }
+        output.flush();
+        return counter.count;
+    }
+
+    void interpret_profiled(const Bytecode& bytecode, Input& input, Output& output, Profiler& profiler, const Limits& limits){
+        try{
+            run_switch(bytecode, prepare(bytecode, Engine::SWITCH, limits), input, output, limits, profiler);
+        }
+        catch(...){
+            profiler.stop();
+            output.flush();
+            throw;
+        }
+        profiler.stop();
+        output.flush();
+    }
+
+    Prepared prepare(const Bytecode& bytecode, const Engine::Engine engine, const Limits& limits){
+        Prepared prepared{engine, limits.metered(), {}, {}, {}, nullptr};
+        if(prepared.metered){
+            prepared.lengths = stretch_lengths(bytecode);
+        }
+        if(engine == Engine::BIGNUM){
+            return prepared;
+        }
+        if(engine == Engine::JIT){
+            // The stretch lengths end up in the code, it doesn't keep a reference to them
+            prepared.native = JIT::compile_native(bytecode, prepared.metered ? &prepared.lengths : nullptr);
+            if(prepared.native != nullptr){
+                return prepared;
+            }
+        }
+        prepared.required = required_depths(bytecode);
+        if(engine != Engine::SWITCH){
+            prepared.threaded = decode_threaded(bytecode, prepared.required, prepared.metered);
+        }
+        return prepared;
+    }
+
+    void interpret(const Bytecode& bytecode, const Prepared& prepared, Input& input, Output& output, const Limits& limits){
+        if(prepared.metered != limits.metered()){
+            throw std::invalid_argument("The program was prepared for runs with different limits");
+        }
+        try{
+            switch(prepared.engine){
+                case Engine::THREADED:
+                    interpret_threaded(bytecode, prepared, input, output, limits);
+                    break;
+                case Engine::JIT:
+                    interpret_jit(bytecode, prepared, input, output, limits);
+                    break;
+                case Engine::BIGNUM:
+                    interpret_bignum(bytecode, prepared, input, output, limits);
+                    break;
+                case Engine::SWITCH:
+                default:
+                    interpret_switch(bytecode, prepared, input, output, limits);
+            }
+        }
+        catch(...){
+            output.flush();     // Whatever was printed before the exception still reaches the sink
+            throw;
+        }
+        output.flush();
+    }
 
-        return result;
+    void interpret(const Bytecode& bytecode, Input& input, Output& output, const Engine::Engine engine, const Limits& limits){
+        interpret(bytecode, prepare(bytecode, engine, limits), input, output, limits);
     }
-}
\ No newline at end of file
+}
@@ -1,11 +1,47 @@
 #pragma once
-#include <sstream>
+#include <string>
+#include <string_view>
 
 #include "Context.hpp"
+#include "Input.hpp"
+#include "Output.hpp"
+#include "Prepared.hpp"
+#include "Profiler.hpp"
+#include "../Options.hpp"
 
 namespace WS{
-    char get_chr(std::stringstream& input);
-    long long get_num(std::stringstream& input);
+    // Digits of the next input number without their 0x / 0b / 0 prefix, raises EofInInput and RuntimeNumberFormatException like get_num
+    struct NumberLiteral{
+        std::string_view digits;
+        int base;
+    };
+    NumberLiteral get_num_literal(Input& input);
 
-    std::string interpret(const ParsingResult info, std::stringstream input);
-}
\ No newline at end of file
+    char get_chr(Input& input);
+    long long get_num(Input& input);
+
+    // Does the work engine needs before it can run bytecode once, whether limits meter the runs decides what is built.
+    // The result is only valid for the same bytecode, engine and Limits::metered()
+    Prepared prepare(const Bytecode& bytecode, const Engine::Engine engine, const Limits& limits = Limits());
+
+    // Threaded programs have to be decoded for metered or unmetered runs, they jump into different instantiations
+    std::vector<ThreadedOp> decode_threaded(const Bytecode& bytecode, const std::vector<size_t>& required, const bool metered);
+
+    void interpret_switch(const Bytecode& bytecode, const Prepared& prepared, Input& input, Output& output, const Limits& limits);
+    void interpret_threaded(const Bytecode& bytecode, const Prepared& prepared, Input& input, Output& output, const Limits& limits);
+
+    // Runs like interpret_switch and returns how many instructions were executed, a superinstruction counts once.
+    // Output is flushed when this returns or throws
+    unsigned long long count_instructions(const Bytecode& bytecode, Input& input, Output& output, const Limits& limits = Limits());
+
+    // Runs like interpret_switch with profiler watching every instruction, a separate instantiation so the other engines don't pay for it.
+    // The profiler is stopped and output flushed when this returns or throws
+    void interpret_profiled(const Bytecode& bytecode, Input& input, Output& output, Profiler& profiler, const Limits& limits = Limits());
+
+    // Runs bytecode on the engine it was prepared for, only the Context and Budget are set up here.
+    // Raises std::invalid_argument if limits.metered() differs from what prepared was built for. output is flushed when this returns or throws
+    void interpret(const Bytecode& bytecode, const Prepared& prepared, Input& input, Output& output, const Limits& limits = Limits());
+
+    // Prepares bytecode for this one run
+    void interpret(const Bytecode& bytecode, Input& input, Output& output, const Engine::Engine engine = Engine::THREADED, const Limits& limits = Limits());
+}
@@ -0,0 +1,215 @@
+#pragma once
+#include <climits>
+#include <cmath>
+#include <optional>
+#include <string>
+
+#include "Context.hpp"
+#include "Input.hpp"
+#include "Output.hpp"
+#include "../exceptions/Messages.hpp"
+
+// The semantics of every instruction that is more than a single Context call, shared by all execution engines
+namespace WS{
+    char get_chr(Input& input);
+    long long get_num(Input& input);
+
+    namespace Operations{
+        inline long long floor_divide(const long long b, const long long a){
+            return std::floor(static_cast<long double>(b) / a);
+        }
+
+        inline long long floor_modulo(const long long b, const long long a){
+            return b - a*std::floor(static_cast<long double>(b) / a);
+        }
+
+        // b <op> a exactly as the functions below compute it, or nothing if that would raise or overflow
+        inline std::optional<long long> checked(const InstructionType::InstructionType type, const long long b, const long long a){
+            switch(type){
+                case InstructionType::ARITHMETIC_ADD:
+                    if((a > 0 && b > LLONG_MAX - a) || (a < 0 && b < LLONG_MIN - a)){
+                        return std::nullopt;
+                    }
+                    return b + a;
+                case InstructionType::ARITHMETIC_SUB:
+                    if((a < 0 && b > LLONG_MAX + a) || (a > 0 && b < LLONG_MIN + a)){
+                        return std::nullopt;
+                    }
+                    return b - a;
+                case InstructionType::ARITHMETIC_MULTIPLICATE:{
+                        const bool fits =
+                            a == 0 || b == 0 ||
+                            (a > 0 && b > 0 && b <= LLONG_MAX / a) ||
+                            (a > 0 && b < 0 && b >= LLONG_MIN / a) ||
+                            (a < 0 && b > 0 && a >= LLONG_MIN / b) ||
+                            (a < 0 && b < 0 && b >= LLONG_MAX / a);
+                        if(!fits){
+                            return std::nullopt;
+                        }
+                        return b * a;
+                    }
+                case InstructionType::ARITHMETIC_DIVIDE:
+                    if(a == 0 || (b == LLONG_MIN && a == -1)){
+                        return std::nullopt;
+                    }
+                    return floor_divide(b, a);
+                case InstructionType::ARITHMETIC_MODULO:
+                    if(a == 0){
+                        return std::nullopt;
+                    }
+                    return floor_modulo(b, a);
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        inline void add(Context& ctx){
+            const long long a = ctx.stack_pop_num();
+            const long long b = ctx.stack_pop_num();
+            ctx.stack_push_num(b + a);
+        }
+
+        inline void sub(Context& ctx){
+            const long long a = ctx.stack_pop_num();
+            const long long b = ctx.stack_pop_num();
+            ctx.stack_push_num(b - a);
+        }
+
+        inline void multiplicate(Context& ctx){
+            const long long a = ctx.stack_pop_num();
+            const long long b = ctx.stack_pop_num();
+            ctx.stack_push_num(b * a);
+        }
+
+        inline void divide(Context& ctx){
+            const long long a = ctx.stack_pop_num();
+            if(a == 0){
+                throw DivideByZeroException(Messages::DIVISION_BY_ZERO);
+            }
+            const long long b = ctx.stack_pop_num();
+            ctx.stack_push_num(floor_divide(b, a));
+        }
+
+        inline void modulo(Context& ctx){
+            const long long a = ctx.stack_pop_num();
+            if(a == 0){
+                throw DivideByZeroException(Messages::DIVISION_BY_ZERO);
+            }
+            const long long b = ctx.stack_pop_num();
+            ctx.stack_push_num(floor_modulo(b, a));
+        }
+
+        inline void output_char(Context& ctx, Output& output){
+            output.put(ctx.stack_pop_char());
+        }
+
+        inline void output_num(Context& ctx, Output& output){
+            output.write_num(ctx.stack_pop_num());
+        }
+
+        inline void input_char(Context& ctx, Input& input){
+            ctx.store_char(get_chr(input));
+        }
+
+        inline void input_num(Context& ctx, Input& input){
+            ctx.store_num(get_num(input));
+        }
+
+        // The same instructions for code whose stack depth was verified up front, see required_depths.
+        // Only stack checks are skipped, everything else still raises
+        namespace Unchecked{
+            inline void dup_n(ValueStack& stack, const long long n){
+                const long long value = stack.top[-1 - n];
+                stack.push_back(value);
+            }
+
+            inline void swap(ValueStack& stack){
+                const long long top = stack.top[-1];
+                stack.top[-1] = stack.top[-2];
+                stack.top[-2] = top;
+            }
+
+            inline long long pop(ValueStack& stack){
+                const long long value = stack.back();
+                stack.pop_back();
+                return value;
+            }
+
+            inline void add(ValueStack& stack){
+                const long long a = pop(stack);
+                stack.top[-1] += a;
+            }
+
+            inline void sub(ValueStack& stack){
+                const long long a = pop(stack);
+                stack.top[-1] -= a;
+            }
+
+            inline void multiplicate(ValueStack& stack){
+                const long long a = pop(stack);
+                stack.top[-1] *= a;
+            }
+
+            inline void divide(ValueStack& stack){
+                const long long a = pop(stack);
+                if(a == 0){
+                    throw DivideByZeroException(Messages::DIVISION_BY_ZERO);
+                }
+                stack.top[-1] = floor_divide(stack.top[-1], a);
+            }
+
+            inline void modulo(ValueStack& stack){
+                const long long a = pop(stack);
+                if(a == 0){
+                    throw DivideByZeroException(Messages::DIVISION_BY_ZERO);
+                }
+                stack.top[-1] = floor_modulo(stack.top[-1], a);
+            }
+
+            inline void sub_swapped(ValueStack& stack){
+                const long long a = pop(stack);
+                stack.top[-1] = a - stack.top[-1];
+            }
+
+            inline void heap_pop(Context& ctx){
+                ValueStack& stack = ctx.values();
+                const long long value = pop(stack);
+                ctx.heap_set(pop(stack), value);
+            }
+
+            inline void heap_push(Context& ctx){
+                ValueStack& stack = ctx.values();
+                const long long addr = pop(stack);
+                stack.push_back(ctx.heap_get(addr));
+            }
+
+            inline void store_num(Context& ctx, const long long num){
+                ctx.heap_set(pop(ctx.values()), num);
+            }
+
+            inline void output_char(ValueStack& stack, Output& output){
+                output.put(static_cast<char>(pop(stack)));
+            }
+
+            inline void output_num(ValueStack& stack, Output& output){
+                output.write_num(pop(stack));
+            }
+
+            inline void input_char(Context& ctx, Input& input){
+                store_num(ctx, static_cast<long long>(get_chr(input)));
+            }
+
+            inline void input_num(Context& ctx, Input& input){
+                store_num(ctx, get_num(input));
+            }
+        }
+
+        [[noreturn]] inline void unclean_exit(const long long index){
+            throw UncleanExit(Messages::UNCLEAN_EXIT_PREFIX + std::to_string(index) + Messages::UNCLEAN_EXIT_SUFFIX);
+        }
+
+        [[noreturn]] inline void unknown_instruction(const InstructionType::InstructionType type){
+            throw UnknownInstructionTypeFound("RUNTIME: Unknown Instruction type " + std::to_string(type) + " found");
+        }
+    }
+}
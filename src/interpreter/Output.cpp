@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+#include "Output.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define WS_POSIX_WRITE 1
+#endif
+
+namespace WS{
+    void Output::use_buffer(std::vector<char>& buffer){
+        begin = buffer.data();
+        cursor = begin;
+        end = begin + buffer.size();
+    }
+
+    void Output::write(std::string_view text){
+        while(!text.empty()){
+            if(cursor == end){
+                drain();
+            }
+            const size_t count = std::min(text.size(), static_cast<size_t>(end - cursor));
+            std::memcpy(cursor, text.data(), count);
+            cursor += count;
+            text.remove_prefix(count);
+        }
+    }
+
+    void Output::flush(){
+        if(cursor != begin){
+            drain();
+        }
+    }
+
+    StringOutput::StringOutput(): buffer(1 << 12){
+        use_buffer(buffer);
+    }
+
+    void StringOutput::drain(){
+        drained = drained || cursor != begin;
+        content.append(begin, cursor);
+        cursor = begin;
+    }
+
+    const std::string& StringOutput::str(){
+        flush();
+        return content;
+    }
+
+    FileOutput::FileOutput(std::FILE* file, const size_t buffer_size): file(file), buffer(std::max(buffer_size, static_cast<size_t>(MAX_NUM_LENGTH))){
+        use_buffer(buffer);
+    }
+
+    void FileOutput::drain(){
+        drained = drained || cursor != begin;
+        const char* from = begin;
+        while(from != cursor){
+#ifdef WS_POSIX_WRITE
+            const ssize_t count = ::write(fileno(file), from, cursor - from);
+            if(count < 0 && errno == EINTR){
+                continue;
+            }
+#else
+            const size_t written = std::fwrite(from, 1, cursor - from, file);
+            const long long count = written == 0 ? -1 : static_cast<long long>(written);
+#endif
+            if(count <= 0){
+                cursor = begin;
+                throw std::system_error(errno, std::generic_category(), "Couldn't write output");
+            }
+            from += count;
+        }
+        cursor = begin;
+#ifndef WS_POSIX_WRITE
+        std::fflush(file);
+#endif
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <charconv>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace WS{
+    // Where OUTPUT_CHAR / OUTPUT_NUM write to. Writes fill [begin, end), subclasses only drain the buffer when it is full or flushed
+    class Output{
+    public:
+        static constexpr std::ptrdiff_t MAX_NUM_LENGTH = 20;    // "-9223372036854775808", every buffer is at least this long
+
+    protected:
+        char* begin = nullptr;
+        char* cursor = nullptr;
+        char* end = nullptr;
+        bool drained = false;   // Whether drain ever passed anything on, set by the subclasses
+
+        // Passes [begin, cursor) on and resets cursor to begin
+        virtual void drain() = 0;
+
+        void use_buffer(std::vector<char>& buffer);
+
+    public:
+        Output() = default;
+        Output(const Output&) = delete;
+        Output& operator=(const Output&) = delete;
+        virtual ~Output() = default;
+
+        void put(const char c){
+            if(cursor == end){
+                drain();
+            }
+            *cursor++ = c;
+        }
+
+        void write(std::string_view text);
+
+        // Formats straight into the buffer, no temporary string
+        void write_num(const long long num){
+            if(end - cursor < MAX_NUM_LENGTH){
+                drain();
+            }
+            cursor = std::to_chars(cursor, end, num).ptr;
+        }
+
+        void flush();
+
+        // Whether nothing was written so far, flushed or not
+        bool empty() const{
+            return cursor == begin && !drained;
+        }
+    };
+
+    // Collects everything in a string, what WS::whitespace returns
+    class StringOutput: public Output{
+    private:
+        std::vector<char> buffer;
+        std::string content;
+
+    protected:
+        void drain() override;
+
+    public:
+        StringOutput();
+
+        // Everything written so far, flushes first
+        const std::string& str();
+    };
+
+    // Writes to a file, e.g. stdout, whenever the fixed size buffer runs full
+    class FileOutput: public Output{
+    private:
+        std::FILE* const file;
+        std::vector<char> buffer;
+
+    protected:
+        void drain() override;
+
+    public:
+        static constexpr size_t DEFAULT_BUFFER_SIZE = 1 << 16;
+
+        // Doesn't take ownership of file. Whatever was written to it through stdio has to be flushed beforehand
+        FileOutput(std::FILE* file, const size_t buffer_size = DEFAULT_BUFFER_SIZE);
+    };
+}
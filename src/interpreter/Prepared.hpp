@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "../Options.hpp"
+
+namespace WS{
+    namespace JIT{
+        class NativeCode;
+    }
+
+    // A pre-decoded instruction of the threaded engine: the addresses of its handlers inside its run loop and its operand.
+    // Execution stays on one kind of handler until the next transfer, see required_depths. Transfers also charge the Budget
+    struct ThreadedOp{
+        const void* handler;
+        const void* verified;       // Skips the stack checks
+        long long operand;
+        size_t required;
+    };
+
+    // Everything an engine works out about a bytecode before it can run it, see prepare. Nothing in it changes afterwards,
+    // so one instance serves any number of runs, also from several threads at once, and a run only sets up its Context and Budget
+    struct Prepared{
+        Engine::Engine engine;
+        bool metered;                                       // Whether it was prepared for Limits::metered() runs
+        std::vector<size_t> required;                       // See required_depths, for every engine but bignum
+        std::vector<size_t> lengths;                        // See stretch_lengths, empty unless metered
+        std::vector<ThreadedOp> threaded;                   // For the threaded engine and the jit falling back to it
+        std::shared_ptr<const JIT::NativeCode> native;      // For the jit, null where it falls back to the threaded engine
+    };
+}
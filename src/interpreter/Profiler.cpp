@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <string>
+#include <utility>
+
+#include "Profiler.hpp"
+#include "../bytecode/Listing.hpp"
+
+namespace WS{
+#ifdef WS_PROFILER_RDTSC
+    const char Profiler::UNIT[] = "cycles";
+#else
+    const char Profiler::UNIT[] = "ns";
+#endif
+
+    Profiler::Profiler(const size_t size): executions(size, 0), ticks(size, 0), frames{Frame{NOTHING, NOTHING, {}, 0, 0, 0}}{}
+
+    size_t Profiler::callee(const size_t caller, const size_t mark){
+        for(size_t above = caller; above != NOTHING; above = frames[above].parent){
+            if(frames[above].mark == mark){
+                return above;
+            }
+        }
+        for(const size_t existing: frames[caller].children){
+            if(frames[existing].mark == mark){
+                return existing;
+            }
+        }
+        frames.push_back(Frame{mark, caller, {}, 0, 0, 0});
+        frames[caller].children.push_back(frames.size() - 1);
+        return frames.size() - 1;
+    }
+
+    template<typename Enter, typename Leave>
+    void Profiler::walk(Enter enter, Leave leave) const{
+        // Explicit stack of (frame, next child), recursive programs nest far deeper than the native stack would allow
+        std::vector<std::pair<size_t, size_t>> pending{{0, 0}};
+        enter(0);
+        while(!pending.empty()){
+            auto& [visited, next] = pending.back();
+            if(next == frames[visited].children.size()){
+                leave(visited);
+                pending.pop_back();
+                continue;
+            }
+            const size_t below = frames[visited].children[next++];
+            enter(below);
+            pending.emplace_back(below, 0);
+        }
+    }
+
+    void Profiler::stop(){
+        if(current != NOTHING){
+            const unsigned long long time = now();
+            ticks[current] += time - started;
+            frames[charged].ticks += time - started;
+            current = NOTHING;
+        }
+    }
+
+    void write_row(std::ostream& output, const unsigned long long ticks, const unsigned long long total, const unsigned long long executions){
+        const double share = total == 0 ? 0 : 100.0 * static_cast<double>(ticks) / static_cast<double>(total);
+        output << std::setw(8) << std::fixed << std::setprecision(2) << share << "% "
+               << std::setw(16) << ticks << ' ' << std::setw(14) << executions << "  ";
+    }
+
+    void Profiler::report(const Bytecode& bytecode, const LabelTable& labels, std::ostream& output, const size_t top) const{
+        constexpr size_t TYPE_COUNT = InstructionType::STORE_TOP_AT_IMM + 1;
+        std::vector<unsigned long long> type_ticks(TYPE_COUNT, 0);
+        std::vector<unsigned long long> type_executions(TYPE_COUNT, 0);
+        for(size_t i = 0; i < bytecode.size(); ++i){
+            type_ticks[bytecode.code[i].type] += ticks[i];
+            type_executions[bytecode.code[i].type] += executions[i];
+        }
+        const unsigned long long total = std::accumulate(ticks.begin(), ticks.end(), 0ULL);
+        const unsigned long long executed = std::accumulate(executions.begin(), executions.end(), 0ULL);
+
+        output << executed << " instructions executed in " << total << ' ' << UNIT << '\n';
+
+        std::vector<size_t> types(TYPE_COUNT);
+        std::iota(types.begin(), types.end(), 0);
+        std::stable_sort(types.begin(), types.end(), [&](const size_t a, const size_t b){ return type_ticks[a] > type_ticks[b]; });
+        output << "\nBy instruction type:\n" << std::setw(9) << "share " << std::setw(17) << UNIT << std::setw(15) << "executions" << "  type\n";
+        for(const size_t type: types){
+            if(type_executions[type] == 0){
+                break;
+            }
+            write_row(output, type_ticks[type], total, type_executions[type]);
+            output << instruction_name(static_cast<InstructionType::InstructionType>(type)) << '\n';
+        }
+
+        std::vector<size_t> hottest(bytecode.size());
+        std::iota(hottest.begin(), hottest.end(), 0);
+        const size_t shown = std::min(top, hottest.size());
+        std::partial_sort(hottest.begin(), hottest.begin() + static_cast<std::ptrdiff_t>(shown), hottest.end(), [&](const size_t a, const size_t b){
+            return ticks[a] != ticks[b] ? ticks[a] > ticks[b] : a < b;
+        });
+        output << "\nHottest instructions, index [type: source span]:\n" << std::setw(9) << "share " << std::setw(17) << UNIT << std::setw(15) << "executions" << "  instruction\n";
+        for(size_t i = 0; i < shown && executions[hottest[i]] != 0; ++i){
+            write_row(output, ticks[hottest[i]], total, executions[hottest[i]]);
+            write_instruction(bytecode, labels, hottest[i], output);
+            output << '\n';
+        }
+
+        // Children always come after their parent, and as no subroutine appears twice on a path its frames' subtrees don't overlap
+        std::vector<unsigned long long> inclusive(frames.size());
+        std::vector<unsigned long long> mark_inclusive(bytecode.size(), 0);
+        std::vector<unsigned long long> mark_self(bytecode.size(), 0);
+        std::vector<unsigned long long> mark_calls(bytecode.size(), 0);
+        for(size_t i = frames.size(); i-- > 1;){
+            inclusive[i] += frames[i].ticks;
+            inclusive[frames[i].parent] += inclusive[i];
+            mark_inclusive[frames[i].mark] += inclusive[i];
+            mark_self[frames[i].mark] += frames[i].ticks;
+            mark_calls[frames[i].mark] += frames[i].calls;
+        }
+
+        std::vector<size_t> called;
+        for(size_t i = 0; i < bytecode.size(); ++i){
+            if(mark_calls[i] != 0){
+                called.push_back(i);
+            }
+        }
+        if(called.empty()){
+            return;
+        }
+        const size_t listed = std::min(top, called.size());
+        std::partial_sort(called.begin(), called.begin() + static_cast<std::ptrdiff_t>(listed), called.end(), [&](const size_t a, const size_t b){
+            return mark_inclusive[a] != mark_inclusive[b] ? mark_inclusive[a] > mark_inclusive[b] : a < b;
+        });
+        output << "\nHottest subroutines, by " << UNIT << " including callees:\n" << std::setw(9) << "share " << std::setw(17) << "inclusive"
+               << std::setw(15) << "self" << std::setw(16) << "calls" << "  label @index [source span]\n";
+        for(size_t i = 0; i < listed; ++i){
+            const size_t mark = called[i];
+            write_row(output, mark_inclusive[mark], total, mark_self[mark]);
+            output << std::setw(14) << mark_calls[mark] << "  ";
+            labels.write_name(static_cast<uint32_t>(bytecode.code[mark].operand), output);
+            output << " @" << mark << " [" << bytecode.spans[mark].from << '-' << bytecode.spans[mark].to << "]\n";
+        }
+    }
+
+    void Profiler::write_folded(const Bytecode& bytecode, const LabelTable& labels, std::ostream& output) const{
+        std::string stack;
+        std::vector<size_t> lengths;    // Of stack before each frame on the path was appended
+        walk([&](const size_t f){
+            lengths.push_back(stack.size());
+            if(frames[f].mark == NOTHING){
+                stack += "(program)";
+            }
+            else{
+                stack += ';';
+                stack += labels.name(static_cast<uint32_t>(bytecode.code[frames[f].mark].operand));
+            }
+            if(frames[f].ticks != 0){
+                output << stack << ' ' << frames[f].ticks << '\n';
+            }
+        }, [&](const size_t){
+            stack.resize(lengths.back());
+            lengths.pop_back();
+        });
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "../bytecode/Bytecode.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define WS_PROFILER_RDTSC 1
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+namespace WS{
+    // Counts how often every instruction runs and the ticks from its start until the next instruction starts.
+    // Ticks are TSC cycles on x86-64 and steady_clock nanoseconds elsewhere, see UNIT.
+    // The ticks are also charged to the call stack they ran on, kept as a tree of frames. Recursion folds into the outermost
+    // call of the same subroutine, so no subroutine appears twice on a path and the tree stays as small as the call graph
+    class Profiler{
+    private:
+        static constexpr size_t NOTHING = SIZE_MAX;
+
+        // One node per distinct call stack, frame 0 is the top level
+        struct Frame{
+            size_t mark;            // The FLOW_MARK index the frame was called at, NOTHING for the top level
+            size_t parent;
+            std::vector<size_t> children;
+            unsigned long long ticks = 0;           // Spent in the frame itself, callees excluded
+            unsigned long long instructions = 0;
+            unsigned long long calls = 0;
+        };
+
+        std::vector<unsigned long long> executions;     // Per instruction index
+        std::vector<unsigned long long> ticks;
+        size_t current = NOTHING;       // The instruction running since started
+        unsigned long long started = 0;
+
+        std::vector<Frame> frames;
+        size_t frame = 0;       // Where the next instruction runs
+        size_t charged = 0;     // Where current runs, a call or return moves frame before current is charged
+        std::vector<size_t> returns;    // The frames the calls came from, parallel to the call stack
+
+        // The frame a call from caller to the FLOW_MARK at mark runs in, created on first use
+        size_t callee(const size_t caller, const size_t mark);
+
+        // Visits the frames depth first, enter(frame) before and leave(frame) after the children of frame
+        template<typename Enter, typename Leave>
+        void walk(Enter enter, Leave leave) const;
+
+        static unsigned long long now(){
+#ifdef WS_PROFILER_RDTSC
+            return __rdtsc();
+#else
+            return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+
+    public:
+        static const char UNIT[];
+
+        Profiler(const size_t size);
+
+        // Called by the interpreter before the instruction at ptr runs
+        void step(const size_t ptr){
+            const unsigned long long time = now();
+            if(current != NOTHING){
+                ticks[current] += time - started;
+                frames[charged].ticks += time - started;
+            }
+            ++executions[ptr];
+            ++frames[frame].instructions;
+            current = ptr;
+            charged = frame;
+            started = time;
+        }
+
+        // Called once a FLOW_CALL to the FLOW_MARK at mark succeeded
+        void call(const size_t mark){
+            returns.push_back(frame);
+            frame = callee(frame, mark);
+            ++frames[frame].calls;
+        }
+
+        // Called once a FLOW_RETURN succeeded
+        void ret(){
+            frame = returns.back();
+            returns.pop_back();
+        }
+
+        // Charges the last instruction, once the program stopped for whatever reason
+        void stop();
+
+        // Totals per instruction type, then the top most expensive instructions with their source spans, both sorted by ticks,
+        // then the top subroutines by ticks including their callees
+        void report(const Bytecode& bytecode, const LabelTable& labels, std::ostream& output, const size_t top = 20) const;
+
+        // Folded stacks as read by flamegraph.pl and speedscope, one "(program);label;label ticks" line per call stack that spent any time
+        void write_folded(const Bytecode& bytecode, const LabelTable& labels, std::ostream& output) const;
+    };
+}
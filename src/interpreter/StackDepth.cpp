@@ -0,0 +1,107 @@
+#include <algorithm>
+
+#include "StackDepth.hpp"
+#include "../optimizer/ControlFlow.hpp"
+
+namespace WS{
+    // What a single instruction needs on the stack and how it changes its size
+    struct StackEffect{
+        size_t needs;
+        long long delta;
+    };
+
+    StackEffect stack_effect(const Op& op){
+        switch(op.type){
+            case InstructionType::STACK_PUSH:
+            case InstructionType::LOAD_IMM_ADDR:
+                return StackEffect{0, 1};
+            case InstructionType::STACK_DUP_TOP:
+                return StackEffect{1, 1};
+            case InstructionType::STACK_DUP_N:
+                if(op.operand < 0 || op.operand >= static_cast<long long>(UNVERIFIABLE_DEPTH / 2)){
+                    return StackEffect{UNVERIFIABLE_DEPTH, 0};
+                }
+                return StackEffect{static_cast<size_t>(op.operand) + 1, 1};
+            case InstructionType::STACK_SWAP:
+                return StackEffect{2, 0};
+            case InstructionType::ARITHMETIC_ADD:
+            case InstructionType::ARITHMETIC_SUB:
+            case InstructionType::ARITHMETIC_MULTIPLICATE:
+            case InstructionType::ARITHMETIC_DIVIDE:
+            case InstructionType::ARITHMETIC_MODULO:
+            case InstructionType::SUB_SWAPPED:
+                return StackEffect{2, -1};
+            case InstructionType::HEAP_POP:
+                return StackEffect{2, -2};
+            case InstructionType::HEAP_PUSH:
+            case InstructionType::ADD_IMM:
+            case InstructionType::SUB_IMM:
+            case InstructionType::JEZ_KEEP:
+            case InstructionType::JLZ_KEEP:
+                return StackEffect{1, 0};
+            case InstructionType::STACK_DISCARD_TOP:
+            case InstructionType::OUTPUT_CHAR:
+            case InstructionType::OUTPUT_NUM:
+            case InstructionType::INPUT_CHAR:
+            case InstructionType::INPUT_NUM:
+            case InstructionType::FLOW_JUMP_EZ:
+            case InstructionType::FLOW_JUMP_LZ:
+            case InstructionType::STORE_IMM:
+            case InstructionType::STORE_TOP_AT_IMM:
+                return StackEffect{1, -1};
+            case InstructionType::FLOW_MARK:
+            case InstructionType::FLOW_CALL:
+            case InstructionType::FLOW_JUMP_JMP:
+            case InstructionType::FLOW_RETURN:
+            case InstructionType::EXIT:
+            case InstructionType::UNCLEAN_EXIT:
+                return StackEffect{0, 0};
+            default:
+                return StackEffect{UNVERIFIABLE_DEPTH, 0};
+        }
+    }
+
+    size_t saturating_add(const size_t depth, const size_t amount){
+        return depth > UNVERIFIABLE_DEPTH - amount ? UNVERIFIABLE_DEPTH : depth + amount;
+    }
+
+    // Depth before STACK_DISCARD_N n that leaves at least `after` values. It keeps the top value of a non-empty stack
+    size_t before_discard(const long long n, const size_t after){
+        if(after <= 1){
+            return after;
+        }
+        if(n < 0){
+            return UNVERIFIABLE_DEPTH;
+        }
+        return saturating_add(after, static_cast<size_t>(n));
+    }
+
+    std::vector<size_t> required_depths(const Bytecode& bytecode){
+        std::vector<size_t> required(bytecode.size() + 1, 0);
+
+        for(size_t i = bytecode.size(); i-- > 0;){
+            const Op& op = bytecode.code[i];
+            const size_t after = ends_block(op.type) ? 0 : required[i + 1];
+
+            if(op.type == InstructionType::STACK_DISCARD_N){
+                required[i] = before_discard(op.operand, after);
+                continue;
+            }
+
+            const StackEffect effect = stack_effect(op);
+            size_t before;
+            if(after == UNVERIFIABLE_DEPTH){
+                before = UNVERIFIABLE_DEPTH;
+            }
+            else if(effect.delta >= 0){
+                const size_t grown = static_cast<size_t>(effect.delta);
+                before = after > grown ? after - grown : 0;
+            }
+            else{
+                before = saturating_add(after, static_cast<size_t>(-effect.delta));
+            }
+            required[i] = std::max(effect.needs, before);
+        }
+        return required;
+    }
+}
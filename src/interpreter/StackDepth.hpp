@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "../bytecode/Bytecode.hpp"
+
+namespace WS{
+    // Depth that never suffices, for instructions that always take the checked path
+    constexpr size_t UNVERIFIABLE_DEPTH = SIZE_MAX;
+
+    // For every instruction, the stack depth that lets it and everything after it up to the next jump, call or return
+    // run without a single stack check. Engines compare against it wherever control enters code other than by falling
+    // through, and fall back to the checked Context operations when the stack is shallower.
+    // Has one extra entry for the end of the code, which requires nothing
+    std::vector<size_t> required_depths(const Bytecode& bytecode);
+}
@@ -0,0 +1,379 @@
+#include <algorithm>
+#include <type_traits>
+
+#include "Interpreter.hpp"
+#include "Operations.hpp"
+#include "Budget.hpp"
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"     // Labels as values are a GNU extension
+
+// Label addresses only stay the same across calls as long as the function is neither inlined nor cloned, decoded programs rely on it
+#if defined(__clang__)
+#define WS_THREADED_PINNED __attribute__((noinline))
+#else
+#define WS_THREADED_PINNED __attribute__((noinline, noclone))
+#if __GNUC__ >= 12
+#pragma GCC diagnostic ignored "-Wdangling-pointer"     // Handing the label addresses out is the point
+#endif
+#endif
+
+#define WS_THREADED_HANDLER(type) table[InstructionType::type] = &&type
+#define WS_VERIFIED_HANDLER(type) verified_table[InstructionType::type] = &&VERIFIED_##type
+#define WS_THREADED_NEXT() ++ptr; goto *program[ptr].handler
+#define WS_VERIFIED_NEXT() ++ptr; goto *program[ptr].verified
+#define WS_THREADED_JUMP(target) ptr = (target); budget.enter(ptr); goto *(stack.size() >= program[ptr].required ? program[ptr].verified : program[ptr].handler)
+
+namespace WS{
+    constexpr size_t TYPE_COUNT = InstructionType::STORE_TOP_AT_IMM + 1;
+
+    // Where the handlers of one instantiation of run_threaded are
+    struct ThreadedHandlers{
+        const void* table[TYPE_COUNT];
+        const void* verified[TYPE_COUNT];
+        const void* unknown;
+    };
+
+    template<typename Meter>
+    struct ThreadedRun{
+        const ThreadedOp* program;      // From decode_threaded for the same Meter
+        const Bytecode& bytecode;
+        Input& input;
+        Output& output;
+        const Limits& limits;
+        Meter& budget;
+    };
+
+    // Executes run. The handler addresses only exist in here, so without a run it writes them to handlers and returns instead
+    template<typename Meter>
+    WS_THREADED_PINNED void run_threaded(const ThreadedRun<Meter>* const run, ThreadedHandlers* const handlers){
+        const void* table[TYPE_COUNT];
+        const void* verified_table[TYPE_COUNT];
+
+        WS_THREADED_HANDLER(STACK_PUSH);
+        WS_THREADED_HANDLER(STACK_DUP_N);
+        WS_THREADED_HANDLER(STACK_DISCARD_N);
+        WS_THREADED_HANDLER(STACK_DUP_TOP);
+        WS_THREADED_HANDLER(STACK_SWAP);
+        WS_THREADED_HANDLER(STACK_DISCARD_TOP);
+        WS_THREADED_HANDLER(ARITHMETIC_ADD);
+        WS_THREADED_HANDLER(ARITHMETIC_SUB);
+        WS_THREADED_HANDLER(ARITHMETIC_MULTIPLICATE);
+        WS_THREADED_HANDLER(ARITHMETIC_DIVIDE);
+        WS_THREADED_HANDLER(ARITHMETIC_MODULO);
+        WS_THREADED_HANDLER(HEAP_POP);
+        WS_THREADED_HANDLER(HEAP_PUSH);
+        WS_THREADED_HANDLER(OUTPUT_CHAR);
+        WS_THREADED_HANDLER(OUTPUT_NUM);
+        WS_THREADED_HANDLER(INPUT_CHAR);
+        WS_THREADED_HANDLER(INPUT_NUM);
+        WS_THREADED_HANDLER(FLOW_MARK);
+        WS_THREADED_HANDLER(FLOW_CALL);
+        WS_THREADED_HANDLER(FLOW_JUMP_JMP);
+        WS_THREADED_HANDLER(FLOW_JUMP_EZ);
+        WS_THREADED_HANDLER(FLOW_JUMP_LZ);
+        WS_THREADED_HANDLER(FLOW_RETURN);
+        WS_THREADED_HANDLER(EXIT);
+        WS_THREADED_HANDLER(UNCLEAN_EXIT);
+        WS_THREADED_HANDLER(ADD_IMM);
+        WS_THREADED_HANDLER(SUB_IMM);
+        WS_THREADED_HANDLER(SUB_SWAPPED);
+        WS_THREADED_HANDLER(JEZ_KEEP);
+        WS_THREADED_HANDLER(JLZ_KEEP);
+        WS_THREADED_HANDLER(LOAD_IMM_ADDR);
+        WS_THREADED_HANDLER(STORE_IMM);
+        WS_THREADED_HANDLER(STORE_TOP_AT_IMM);
+
+        // Transfers pick their handler themselves, so they are shared
+        for(size_t type = 0; type < TYPE_COUNT; ++type){
+            verified_table[type] = table[type];
+        }
+        WS_VERIFIED_HANDLER(STACK_PUSH);
+        WS_VERIFIED_HANDLER(STACK_DUP_N);
+        WS_VERIFIED_HANDLER(STACK_DISCARD_N);
+        WS_VERIFIED_HANDLER(STACK_DUP_TOP);
+        WS_VERIFIED_HANDLER(STACK_SWAP);
+        WS_VERIFIED_HANDLER(STACK_DISCARD_TOP);
+        WS_VERIFIED_HANDLER(ARITHMETIC_ADD);
+        WS_VERIFIED_HANDLER(ARITHMETIC_SUB);
+        WS_VERIFIED_HANDLER(ARITHMETIC_MULTIPLICATE);
+        WS_VERIFIED_HANDLER(ARITHMETIC_DIVIDE);
+        WS_VERIFIED_HANDLER(ARITHMETIC_MODULO);
+        WS_VERIFIED_HANDLER(HEAP_POP);
+        WS_VERIFIED_HANDLER(HEAP_PUSH);
+        WS_VERIFIED_HANDLER(OUTPUT_CHAR);
+        WS_VERIFIED_HANDLER(OUTPUT_NUM);
+        WS_VERIFIED_HANDLER(INPUT_CHAR);
+        WS_VERIFIED_HANDLER(INPUT_NUM);
+        WS_VERIFIED_HANDLER(FLOW_MARK);
+        WS_VERIFIED_HANDLER(FLOW_JUMP_EZ);
+        WS_VERIFIED_HANDLER(FLOW_JUMP_LZ);
+        WS_VERIFIED_HANDLER(ADD_IMM);
+        WS_VERIFIED_HANDLER(SUB_IMM);
+        WS_VERIFIED_HANDLER(SUB_SWAPPED);
+        WS_VERIFIED_HANDLER(JEZ_KEEP);
+        WS_VERIFIED_HANDLER(JLZ_KEEP);
+        WS_VERIFIED_HANDLER(LOAD_IMM_ADDR);
+        WS_VERIFIED_HANDLER(STORE_IMM);
+        WS_VERIFIED_HANDLER(STORE_TOP_AT_IMM);
+
+        if(run == nullptr){
+            std::copy(table, table + TYPE_COUNT, handlers->table);
+            std::copy(verified_table, verified_table + TYPE_COUNT, handlers->verified);
+            handlers->unknown = &&UNKNOWN;
+            return;
+        }
+
+        const ThreadedOp* const program = run->program;
+        const Bytecode& bytecode = run->bytecode;
+        Input& input = run->input;
+        Output& output = run->output;
+        Meter& budget = run->budget;
+
+        Context ctx(run->limits);
+        ValueStack& stack = ctx.values();
+        size_t ptr = 0;
+
+        WS_THREADED_JUMP(0);
+
+        STACK_PUSH:
+            ctx.stack_push_num(program[ptr].operand);
+            WS_THREADED_NEXT();
+        STACK_DUP_N:
+            ctx.stack_dup_n(static_cast<size_t>(program[ptr].operand));
+            WS_THREADED_NEXT();
+        STACK_DUP_TOP:
+            ctx.stack_dup_top();
+            WS_THREADED_NEXT();
+        STACK_DISCARD_N:
+            ctx.stack_discard_n(program[ptr].operand);
+            WS_THREADED_NEXT();
+        STACK_DISCARD_TOP:
+            ctx.stack_discard_top();
+            WS_THREADED_NEXT();
+        STACK_SWAP:
+            ctx.stack_swap_top();
+            WS_THREADED_NEXT();
+        ARITHMETIC_ADD:
+            Operations::add(ctx);
+            WS_THREADED_NEXT();
+        ARITHMETIC_SUB:
+            Operations::sub(ctx);
+            WS_THREADED_NEXT();
+        ARITHMETIC_MULTIPLICATE:
+            Operations::multiplicate(ctx);
+            WS_THREADED_NEXT();
+        ARITHMETIC_DIVIDE:
+            Operations::divide(ctx);
+            WS_THREADED_NEXT();
+        ARITHMETIC_MODULO:
+            Operations::modulo(ctx);
+            WS_THREADED_NEXT();
+        HEAP_POP:
+            ctx.heap_pop();
+            WS_THREADED_NEXT();
+        HEAP_PUSH:
+            ctx.heap_push();
+            WS_THREADED_NEXT();
+        OUTPUT_CHAR:
+            Operations::output_char(ctx, output);
+            WS_THREADED_NEXT();
+        OUTPUT_NUM:
+            Operations::output_num(ctx, output);
+            WS_THREADED_NEXT();
+        INPUT_CHAR:
+            Operations::input_char(ctx, input);
+            WS_THREADED_NEXT();
+        INPUT_NUM:
+            Operations::input_num(ctx, input);
+            WS_THREADED_NEXT();
+        FLOW_MARK:
+            WS_THREADED_NEXT();
+        FLOW_CALL:
+            ctx.call(ptr);
+            WS_THREADED_JUMP(program[ptr].operand + 1);
+        FLOW_JUMP_JMP:
+            WS_THREADED_JUMP(program[ptr].operand + 1);
+        FLOW_JUMP_EZ:
+            if(ctx.stack_pop_num() == 0){
+                WS_THREADED_JUMP(program[ptr].operand + 1);
+            }
+            WS_THREADED_JUMP(ptr + 1);
+        FLOW_JUMP_LZ:
+            if(ctx.stack_pop_num() < 0){
+                WS_THREADED_JUMP(program[ptr].operand + 1);
+            }
+            WS_THREADED_JUMP(ptr + 1);
+        FLOW_RETURN:
+            WS_THREADED_JUMP(ctx.ret() + 1);
+        ADD_IMM:
+            ctx.stack_add_imm(program[ptr].operand);
+            WS_THREADED_NEXT();
+        SUB_IMM:
+            ctx.stack_sub_imm(program[ptr].operand);
+            WS_THREADED_NEXT();
+        SUB_SWAPPED:
+            ctx.stack_sub_swapped();
+            WS_THREADED_NEXT();
+        JEZ_KEEP:
+            if(ctx.stack_peek_dup() == 0){
+                WS_THREADED_JUMP(program[ptr].operand + 1);
+            }
+            WS_THREADED_JUMP(ptr + 1);
+        JLZ_KEEP:
+            if(ctx.stack_peek_dup() < 0){
+                WS_THREADED_JUMP(program[ptr].operand + 1);
+            }
+            WS_THREADED_JUMP(ptr + 1);
+        LOAD_IMM_ADDR:
+            ctx.heap_load(program[ptr].operand);
+            WS_THREADED_NEXT();
+        STORE_IMM:
+            ctx.heap_store_imm(program[ptr].operand);
+            WS_THREADED_NEXT();
+        STORE_TOP_AT_IMM:
+            ctx.heap_store_top(program[ptr].operand);
+            WS_THREADED_NEXT();
+
+        VERIFIED_STACK_PUSH:
+            stack.push_back(program[ptr].operand);
+            WS_VERIFIED_NEXT();
+        VERIFIED_STACK_DUP_N:
+            Operations::Unchecked::dup_n(stack, program[ptr].operand);
+            WS_VERIFIED_NEXT();
+        VERIFIED_STACK_DUP_TOP:
+            Operations::Unchecked::dup_n(stack, 0);
+            WS_VERIFIED_NEXT();
+        VERIFIED_STACK_DISCARD_N:
+            ctx.stack_discard_n(program[ptr].operand);
+            WS_VERIFIED_NEXT();
+        VERIFIED_STACK_DISCARD_TOP:
+            stack.pop_back();
+            WS_VERIFIED_NEXT();
+        VERIFIED_STACK_SWAP:
+            Operations::Unchecked::swap(stack);
+            WS_VERIFIED_NEXT();
+        VERIFIED_ARITHMETIC_ADD:
+            Operations::Unchecked::add(stack);
+            WS_VERIFIED_NEXT();
+        VERIFIED_ARITHMETIC_SUB:
+            Operations::Unchecked::sub(stack);
+            WS_VERIFIED_NEXT();
+        VERIFIED_ARITHMETIC_MULTIPLICATE:
+            Operations::Unchecked::multiplicate(stack);
+            WS_VERIFIED_NEXT();
+        VERIFIED_ARITHMETIC_DIVIDE:
+            Operations::Unchecked::divide(stack);
+            WS_VERIFIED_NEXT();
+        VERIFIED_ARITHMETIC_MODULO:
+            Operations::Unchecked::modulo(stack);
+            WS_VERIFIED_NEXT();
+        VERIFIED_HEAP_POP:
+            Operations::Unchecked::heap_pop(ctx);
+            WS_VERIFIED_NEXT();
+        VERIFIED_HEAP_PUSH:
+            Operations::Unchecked::heap_push(ctx);
+            WS_VERIFIED_NEXT();
+        VERIFIED_OUTPUT_CHAR:
+            Operations::Unchecked::output_char(stack, output);
+            WS_VERIFIED_NEXT();
+        VERIFIED_OUTPUT_NUM:
+            Operations::Unchecked::output_num(stack, output);
+            WS_VERIFIED_NEXT();
+        VERIFIED_INPUT_CHAR:
+            Operations::Unchecked::input_char(ctx, input);
+            WS_VERIFIED_NEXT();
+        VERIFIED_INPUT_NUM:
+            Operations::Unchecked::input_num(ctx, input);
+            WS_VERIFIED_NEXT();
+        VERIFIED_FLOW_MARK:
+            WS_VERIFIED_NEXT();
+        VERIFIED_FLOW_JUMP_EZ:
+            if(Operations::Unchecked::pop(stack) == 0){
+                WS_THREADED_JUMP(program[ptr].operand + 1);
+            }
+            WS_THREADED_JUMP(ptr + 1);
+        VERIFIED_FLOW_JUMP_LZ:
+            if(Operations::Unchecked::pop(stack) < 0){
+                WS_THREADED_JUMP(program[ptr].operand + 1);
+            }
+            WS_THREADED_JUMP(ptr + 1);
+        VERIFIED_ADD_IMM:
+            stack.top[-1] += program[ptr].operand;
+            WS_VERIFIED_NEXT();
+        VERIFIED_SUB_IMM:
+            stack.top[-1] -= program[ptr].operand;
+            WS_VERIFIED_NEXT();
+        VERIFIED_SUB_SWAPPED:
+            Operations::Unchecked::sub_swapped(stack);
+            WS_VERIFIED_NEXT();
+        VERIFIED_JEZ_KEEP:
+            if(stack.back() == 0){
+                WS_THREADED_JUMP(program[ptr].operand + 1);
+            }
+            WS_THREADED_JUMP(ptr + 1);
+        VERIFIED_JLZ_KEEP:
+            if(stack.back() < 0){
+                WS_THREADED_JUMP(program[ptr].operand + 1);
+            }
+            WS_THREADED_JUMP(ptr + 1);
+        VERIFIED_LOAD_IMM_ADDR:
+            ctx.heap_load(program[ptr].operand);
+            WS_VERIFIED_NEXT();
+        VERIFIED_STORE_IMM:
+            Operations::Unchecked::store_num(ctx, program[ptr].operand);
+            WS_VERIFIED_NEXT();
+        VERIFIED_STORE_TOP_AT_IMM:
+            ctx.heap_set(program[ptr].operand, Operations::Unchecked::pop(stack));
+            WS_VERIFIED_NEXT();
+
+        UNCLEAN_EXIT:
+            Operations::unclean_exit(program[ptr].operand);
+        UNKNOWN:
+            Operations::unknown_instruction(bytecode.code[ptr].type);
+        EXIT:
+            return;
+    }
+
+    template<typename Meter>
+    std::vector<ThreadedOp> decode(const Bytecode& bytecode, const std::vector<size_t>& required){
+        ThreadedHandlers handlers;
+        run_threaded<Meter>(nullptr, &handlers);
+
+        std::vector<ThreadedOp> program;
+        program.reserve(bytecode.size());
+        for(size_t i = 0; i < bytecode.size(); ++i){
+            const Op& op = bytecode.code[i];
+            const bool known = static_cast<size_t>(op.type) < TYPE_COUNT;
+            program.push_back(ThreadedOp{known ? handlers.table[op.type] : handlers.unknown, known ? handlers.verified[op.type] : handlers.unknown, op.operand, required[i]});
+        }
+        return program;
+    }
+
+    std::vector<ThreadedOp> decode_threaded(const Bytecode& bytecode, const std::vector<size_t>& required, const bool metered){
+        return metered ? decode<Budget>(bytecode, required) : decode<Unmetered>(bytecode, required);
+    }
+
+    void interpret_threaded(const Bytecode& bytecode, const Prepared& prepared, Input& input, Output& output, const Limits& limits){
+        with_budget(prepared.lengths, limits, [&](auto& budget){
+            const ThreadedRun<std::remove_reference_t<decltype(budget)>> run{prepared.threaded.data(), bytecode, input, output, limits, budget};
+            run_threaded(&run, nullptr);
+        });
+    }
+}
+
+#pragma GCC diagnostic pop
+#else
+
+namespace WS{
+    std::vector<ThreadedOp> decode_threaded(const Bytecode&, const std::vector<size_t>&, const bool){
+        return std::vector<ThreadedOp>();
+    }
+
+    void interpret_threaded(const Bytecode& bytecode, const Prepared& prepared, Input& input, Output& output, const Limits& limits){
+        interpret_switch(bytecode, prepared, input, output, limits);
+    }
+}
+
+#endif
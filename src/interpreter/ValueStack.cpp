@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <utility>
+
+#include "ValueStack.hpp"
+#include "../exceptions/Exceptions.hpp"
+#include "../exceptions/Messages.hpp"
+
+namespace WS{
+    constexpr size_t INITIAL_CAPACITY = 64;
+
+    ValueStack::ValueStack(const size_t limit): base(new long long[std::min(INITIAL_CAPACITY, limit)]), top(base), end(base + std::min(INITIAL_CAPACITY, limit)), limit(limit){}
+
+    ValueStack::ValueStack(const ValueStack& stack): base(new long long[stack.end - stack.base]), top(base + stack.size()), end(base + (stack.end - stack.base)), limit(stack.limit){
+        std::copy(stack.base, stack.top, base);
+    }
+
+    ValueStack::ValueStack(ValueStack&& stack) noexcept: base(stack.base), top(stack.top), end(stack.end), limit(stack.limit){
+        stack.base = stack.top = stack.end = nullptr;
+    }
+
+    ValueStack& ValueStack::operator=(ValueStack stack) noexcept{
+        std::swap(base, stack.base);
+        std::swap(top, stack.top);
+        std::swap(end, stack.end);
+        std::swap(limit, stack.limit);
+        return *this;
+    }
+
+    ValueStack::~ValueStack(){
+        delete[] base;
+    }
+
+    void ValueStack::grow(){
+        const size_t size = this->size();
+        if(size >= limit){
+            throw ValueStackOverflow(Messages::VALUE_STACK_OVERFLOW_PREFIX + std::to_string(limit));
+        }
+        const size_t capacity = std::min(limit, std::max(INITIAL_CAPACITY, static_cast<size_t>(end - base) * 2));
+
+        long long* const grown = new long long[capacity];
+        std::copy(base, top, grown);
+        delete[] base;
+
+        base = grown;
+        top = base + size;
+        end = base + capacity;
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace WS{
+    // Contiguous stack of values, addressed through raw pointers so compiled code can work on it directly.
+    // It performs no checks, Context is responsible for raising the runtime exceptions. The one exception is the depth limit:
+    // the capacity never grows past it, so only grow has to look at it and raises ValueStackOverflow
+    class ValueStack{
+    public:
+        long long* base;
+        long long* top;     // One past the last value
+        long long* end;     // One past the allocated capacity
+        size_t limit;       // Maximum number of values
+
+        ValueStack(const size_t limit = SIZE_MAX);
+        ValueStack(const ValueStack& stack);
+        ValueStack(ValueStack&& stack) noexcept;
+        ValueStack& operator=(ValueStack stack) noexcept;
+        ~ValueStack();
+
+        bool empty() const{
+            return top == base;
+        }
+
+        size_t size() const{
+            return static_cast<size_t>(top - base);
+        }
+
+        long long back() const{
+            return top[-1];
+        }
+
+        long long operator[](const size_t index) const{
+            return base[index];
+        }
+
+        void pop_back(){
+            --top;
+        }
+
+        void push_back(const long long value){
+            if(top == end){
+                grow();
+            }
+            *top++ = value;
+        }
+
+        void grow();
+    };
+}
@@ -0,0 +1,215 @@
+#include <stdexcept>
+
+#include "Assembler.hpp"
+
+namespace WS{
+    namespace JIT{
+        void Assembler::byte(const uint8_t value){
+            code.push_back(value);
+        }
+
+        void Assembler::int32(const int32_t value){
+            const uint32_t bits = static_cast<uint32_t>(value);
+            for(int i = 0; i < 4; ++i){
+                byte(static_cast<uint8_t>(bits >> (8*i)));
+            }
+        }
+
+        void Assembler::int64(const int64_t value){
+            const uint64_t bits = static_cast<uint64_t>(value);
+            for(int i = 0; i < 8; ++i){
+                byte(static_cast<uint8_t>(bits >> (8*i)));
+            }
+        }
+
+        void Assembler::rex(const bool wide, const unsigned reg, const unsigned rm){
+            const uint8_t prefix = 0x40 | (wide ? 0x08 : 0) | ((reg >> 3) << 2) | (rm >> 3);
+            if(prefix != 0x40){
+                byte(prefix);
+            }
+        }
+
+        void Assembler::modrm_register(const unsigned reg, const unsigned rm){
+            byte(0xC0 | ((reg & 7) << 3) | (rm & 7));
+        }
+
+        void Assembler::modrm_memory(const unsigned reg, const Register::Register base, const int32_t disp){
+            byte(0x80 | ((reg & 7) << 3) | (base & 7));
+            if((base & 7) == Register::RSP){    // RSP and R12 need a SIB byte
+                byte(0x24);
+            }
+            int32(disp);
+        }
+
+        void Assembler::rel32(const size_t label){
+            fixups.push_back(Fixup{code.size(), label});
+            int32(0);
+        }
+
+        size_t Assembler::new_label(){
+            labels.push_back(-1);
+            return labels.size() - 1;
+        }
+
+        void Assembler::bind(const size_t label){
+            labels[label] = static_cast<long long>(code.size());
+        }
+
+        size_t Assembler::offset_of(const size_t label) const{
+            return static_cast<size_t>(labels[label]);
+        }
+
+        void Assembler::push(const Register::Register reg){
+            rex(false, 0, reg);
+            byte(0x50 | (reg & 7));
+        }
+
+        void Assembler::pop(const Register::Register reg){
+            rex(false, 0, reg);
+            byte(0x58 | (reg & 7));
+        }
+
+        void Assembler::mov(const Register::Register dst, const Register::Register src){
+            rex(true, src, dst);
+            byte(0x89);
+            modrm_register(src, dst);
+        }
+
+        void Assembler::mov(const Register::Register dst, const long long imm){
+            rex(true, 0, dst);
+            byte(0xB8 | (dst & 7));
+            int64(imm);
+        }
+
+        void Assembler::load(const Register::Register dst, const Register::Register base, const int32_t disp){
+            rex(true, dst, base);
+            byte(0x8B);
+            modrm_memory(dst, base, disp);
+        }
+
+        void Assembler::store(const Register::Register base, const int32_t disp, const Register::Register src){
+            rex(true, src, base);
+            byte(0x89);
+            modrm_memory(src, base, disp);
+        }
+
+        void Assembler::sub_memory(const Register::Register base, const int32_t disp, const int32_t imm){
+            rex(true, 0, base);
+            byte(0x81);
+            modrm_memory(5, base, disp);
+            int32(imm);
+        }
+
+        void Assembler::add(const Register::Register dst, const int32_t imm){
+            rex(true, 0, dst);
+            byte(0x81);
+            modrm_register(0, dst);
+            int32(imm);
+        }
+
+        void Assembler::sub(const Register::Register dst, const int32_t imm){
+            rex(true, 0, dst);
+            byte(0x81);
+            modrm_register(5, dst);
+            int32(imm);
+        }
+
+        void Assembler::cmp(const Register::Register lhs, const int32_t imm){
+            rex(true, 0, lhs);
+            byte(0x81);
+            modrm_register(7, lhs);
+            int32(imm);
+        }
+
+        void Assembler::add(const Register::Register dst, const Register::Register src){
+            rex(true, src, dst);
+            byte(0x01);
+            modrm_register(src, dst);
+        }
+
+        void Assembler::sub(const Register::Register dst, const Register::Register src){
+            rex(true, src, dst);
+            byte(0x29);
+            modrm_register(src, dst);
+        }
+
+        void Assembler::imul(const Register::Register dst, const Register::Register src){
+            rex(true, dst, src);
+            byte(0x0F);
+            byte(0xAF);
+            modrm_register(dst, src);
+        }
+
+        void Assembler::cmp(const Register::Register lhs, const Register::Register rhs){
+            rex(true, rhs, lhs);
+            byte(0x39);
+            modrm_register(rhs, lhs);
+        }
+
+        void Assembler::test(const Register::Register lhs, const Register::Register rhs){
+            rex(true, rhs, lhs);
+            byte(0x85);
+            modrm_register(rhs, lhs);
+        }
+
+        void Assembler::test32(const Register::Register lhs, const Register::Register rhs){
+            rex(false, rhs, lhs);
+            byte(0x85);
+            modrm_register(rhs, lhs);
+        }
+
+        void Assembler::mov32(const Register::Register dst, const int32_t imm){
+            rex(false, 0, dst);
+            byte(0xB8 | (dst & 7));
+            int32(imm);
+        }
+
+        void Assembler::jcc(const Condition::Condition condition, const size_t label){
+            byte(0x0F);
+            byte(0x80 | condition);
+            rel32(label);
+        }
+
+        void Assembler::jmp(const size_t label){
+            byte(0xE9);
+            rel32(label);
+        }
+
+        void Assembler::jmp(const Register::Register target){
+            rex(false, 0, target);
+            byte(0xFF);
+            modrm_register(4, target);
+        }
+
+        void Assembler::jmp_indexed(const Register::Register table, const Register::Register index){
+            rex(false, index, table);
+            byte(0xFF);
+            byte(0x24);                                         // mod 00, /4, SIB follows
+            byte(0xC0 | ((index & 7) << 3) | (table & 7));      // scale 8
+        }
+
+        void Assembler::call(const Register::Register target){
+            rex(false, 0, target);
+            byte(0xFF);
+            modrm_register(2, target);
+        }
+
+        void Assembler::ret(){
+            byte(0xC3);
+        }
+
+        void Assembler::finalize(){
+            for(const Fixup& fixup: fixups){
+                if(labels[fixup.label] < 0){
+                    throw std::logic_error("JIT: branch to an unbound label");
+                }
+                const long long distance = labels[fixup.label] - static_cast<long long>(fixup.position + 4);
+                const uint32_t bits = static_cast<uint32_t>(static_cast<int32_t>(distance));
+                for(int i = 0; i < 4; ++i){
+                    code[fixup.position + i] = static_cast<uint8_t>(bits >> (8*i));
+                }
+            }
+            fixups.clear();
+        }
+    }
+}
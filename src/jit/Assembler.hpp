@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace WS{
+    namespace JIT{
+        namespace Register{
+            enum Register{
+                RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+                R8, R9, R10, R11, R12, R13, R14, R15
+            };
+        }
+
+        namespace Condition{
+            enum Condition{
+                BELOW = 0x2,
+                ABOVE_EQUAL = 0x3,
+                EQUAL = 0x4,
+                NOT_EQUAL = 0x5,
+                LESS = 0xC,
+            };
+        }
+
+        // Minimal x86-64 encoder for the handful of instructions the JIT emits.
+        // All memory operands are [base + disp32], all branches are rel32 and get patched in finalize()
+        class Assembler{
+        private:
+            struct Fixup{
+                size_t position;
+                size_t label;
+            };
+
+            std::vector<long long> labels;
+            std::vector<Fixup> fixups;
+
+            void byte(const uint8_t value);
+            void int32(const int32_t value);
+            void int64(const int64_t value);
+            void rex(const bool wide, const unsigned reg, const unsigned rm);
+            void modrm_register(const unsigned reg, const unsigned rm);
+            void modrm_memory(const unsigned reg, const Register::Register base, const int32_t disp);
+            void rel32(const size_t label);
+        public:
+            std::vector<uint8_t> code;
+
+            size_t new_label();
+            void bind(const size_t label);
+            size_t offset_of(const size_t label) const;
+
+            void push(const Register::Register reg);
+            void pop(const Register::Register reg);
+
+            void mov(const Register::Register dst, const Register::Register src);
+            void mov(const Register::Register dst, const long long imm);
+            void load(const Register::Register dst, const Register::Register base, const int32_t disp);
+            void store(const Register::Register base, const int32_t disp, const Register::Register src);
+            void sub_memory(const Register::Register base, const int32_t disp, const int32_t imm);      // sub qword [base + disp], imm
+
+            void add(const Register::Register dst, const int32_t imm);
+            void sub(const Register::Register dst, const int32_t imm);
+            void cmp(const Register::Register lhs, const int32_t imm);
+
+            void add(const Register::Register dst, const Register::Register src);
+            void sub(const Register::Register dst, const Register::Register src);
+            void imul(const Register::Register dst, const Register::Register src);
+            void cmp(const Register::Register lhs, const Register::Register rhs);
+            void test(const Register::Register lhs, const Register::Register rhs);
+            void test32(const Register::Register lhs, const Register::Register rhs);
+            void mov32(const Register::Register dst, const int32_t imm);
+
+            void jcc(const Condition::Condition condition, const size_t label);
+            void jmp(const size_t label);
+            void jmp(const Register::Register target);
+            void jmp_indexed(const Register::Register table, const Register::Register index);   // jmp [table + index*8]
+            void call(const Register::Register target);
+            void ret();
+
+            void finalize();
+        };
+    }
+}
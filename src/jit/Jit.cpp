@@ -0,0 +1,524 @@
+#include "Jit.hpp"
+#include "../interpreter/Interpreter.hpp"
+
+#if defined(__x86_64__) && defined(__unix__)
+#define WS_JIT_AVAILABLE 1
+#endif
+
+#ifdef WS_JIT_AVAILABLE
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <sys/mman.h>
+
+#include "Assembler.hpp"
+#include "../interpreter/Budget.hpp"
+#include "../interpreter/Operations.hpp"
+
+// Code layout:
+//   rbx = JitFrame*, r15 = ValueStack*, r12 = ValueStack::top, r13 = ValueStack::base, r14 = ValueStack::end
+// Simple stack instructions and branches are emitted inline. Everything else, and every fast path whose
+// precondition fails, calls a helper that runs the same Context / Operations code as the interpreters.
+// Metered runs charge the Budget's fuel inline on every transfer and call a helper only once it runs out,
+// unmetered runs don't emit any of it.
+// Helpers catch all exceptions and report them through their return value, so no C++ exception ever
+// unwinds through generated code, the caller rethrows it once the generated function has returned.
+
+#define WS_JIT_HELPER(name) int name(JitFrame* frame, [[maybe_unused]] const long long operand)
+#define WS_JIT_GUARDED(body) try{ body; return 0; } catch(...){ *frame->error = std::current_exception(); return 1; }
+
+namespace WS{
+    namespace JIT{
+        using namespace Register;
+
+        struct JitFrame{
+            size_t return_index;        // Written by helper_return, read by the generated code
+            Context* ctx;
+            Output* output;
+            Input* input;
+            std::exception_ptr* error;
+            long long* fuel;            // The budget's, charged by the generated code
+            Budget* budget;
+        };
+
+        using Helper = int (*)(JitFrame*, const long long);
+        using Entry = int (*)(JitFrame*, ValueStack*);
+
+        constexpr int32_t SLOT = sizeof(long long);
+        constexpr int32_t STACK_BASE = offsetof(ValueStack, base);
+        constexpr int32_t STACK_TOP = offsetof(ValueStack, top);
+        constexpr int32_t STACK_END = offsetof(ValueStack, end);
+        constexpr int32_t FRAME_RETURN_INDEX = offsetof(JitFrame, return_index);
+        constexpr int32_t FRAME_FUEL = offsetof(JitFrame, fuel);
+
+        WS_JIT_HELPER(helper_push){ WS_JIT_GUARDED(frame->ctx->stack_push_num(operand)) }
+        WS_JIT_HELPER(helper_dup_n){ WS_JIT_GUARDED(frame->ctx->stack_dup_n(operand)) }
+        WS_JIT_HELPER(helper_discard_n){ WS_JIT_GUARDED(frame->ctx->stack_discard_n(operand)) }
+        WS_JIT_HELPER(helper_discard_top){ WS_JIT_GUARDED(frame->ctx->stack_discard_top()) }
+        WS_JIT_HELPER(helper_swap){ WS_JIT_GUARDED(frame->ctx->stack_swap_top()) }
+        WS_JIT_HELPER(helper_pop){ WS_JIT_GUARDED(frame->ctx->stack_pop_num()) }
+
+        WS_JIT_HELPER(helper_add){ WS_JIT_GUARDED(Operations::add(*frame->ctx)) }
+        WS_JIT_HELPER(helper_sub){ WS_JIT_GUARDED(Operations::sub(*frame->ctx)) }
+        WS_JIT_HELPER(helper_multiplicate){ WS_JIT_GUARDED(Operations::multiplicate(*frame->ctx)) }
+        WS_JIT_HELPER(helper_divide){ WS_JIT_GUARDED(Operations::divide(*frame->ctx)) }
+        WS_JIT_HELPER(helper_modulo){ WS_JIT_GUARDED(Operations::modulo(*frame->ctx)) }
+
+        WS_JIT_HELPER(helper_heap_pop){ WS_JIT_GUARDED(frame->ctx->heap_pop()) }
+        WS_JIT_HELPER(helper_heap_push){ WS_JIT_GUARDED(frame->ctx->heap_push()) }
+
+        WS_JIT_HELPER(helper_output_char){ WS_JIT_GUARDED(Operations::output_char(*frame->ctx, *frame->output)) }
+        WS_JIT_HELPER(helper_output_num){ WS_JIT_GUARDED(Operations::output_num(*frame->ctx, *frame->output)) }
+        WS_JIT_HELPER(helper_input_char){ WS_JIT_GUARDED(Operations::input_char(*frame->ctx, *frame->input)) }
+        WS_JIT_HELPER(helper_input_num){ WS_JIT_GUARDED(Operations::input_num(*frame->ctx, *frame->input)) }
+
+        WS_JIT_HELPER(helper_call){ WS_JIT_GUARDED(frame->ctx->call(static_cast<size_t>(operand))) }
+        WS_JIT_HELPER(helper_return){ WS_JIT_GUARDED(frame->return_index = frame->ctx->ret()) }
+        WS_JIT_HELPER(helper_return_metered){ WS_JIT_GUARDED(frame->return_index = frame->ctx->ret(); frame->budget->enter(frame->return_index + 1)) }
+        WS_JIT_HELPER(helper_refuel){ WS_JIT_GUARDED(frame->budget->refuel()) }
+
+        WS_JIT_HELPER(helper_add_imm){ WS_JIT_GUARDED(frame->ctx->stack_add_imm(operand)) }
+        WS_JIT_HELPER(helper_sub_imm){ WS_JIT_GUARDED(frame->ctx->stack_sub_imm(operand)) }
+        WS_JIT_HELPER(helper_sub_swapped){ WS_JIT_GUARDED(frame->ctx->stack_sub_swapped()) }
+        WS_JIT_HELPER(helper_peek){ WS_JIT_GUARDED(frame->ctx->stack_peek_dup()) }
+        WS_JIT_HELPER(helper_heap_load){ WS_JIT_GUARDED(frame->ctx->heap_load(operand)) }
+        WS_JIT_HELPER(helper_heap_store_imm){ WS_JIT_GUARDED(frame->ctx->heap_store_imm(operand)) }
+        WS_JIT_HELPER(helper_heap_store_top){ WS_JIT_GUARDED(frame->ctx->heap_store_top(operand)) }
+
+        WS_JIT_HELPER(helper_unclean_exit){ WS_JIT_GUARDED(Operations::unclean_exit(operand)) }
+        WS_JIT_HELPER(helper_unknown){ WS_JIT_GUARDED(Operations::unknown_instruction(static_cast<InstructionType::InstructionType>(operand))) }
+
+        // Executable copy of the generated code, owns the mapping
+        class NativeCode{
+        private:
+            void* memory;
+            size_t length;
+        public:
+            std::vector<const void*> return_targets;    // Instruction index of a FLOW_CALL -> native address of the instruction after it
+
+            NativeCode(): memory(MAP_FAILED), length(0){}
+            NativeCode(const NativeCode&) = delete;
+            NativeCode& operator=(const NativeCode&) = delete;
+            ~NativeCode(){
+                if(memory != MAP_FAILED){
+                    munmap(memory, length);
+                }
+            }
+
+            bool load(const std::vector<uint8_t>& code){
+                length = code.size();
+                memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if(memory == MAP_FAILED){
+                    return false;
+                }
+                std::memcpy(memory, code.data(), length);
+                return mprotect(memory, length, PROT_READ | PROT_EXEC) == 0;
+            }
+
+            const uint8_t* address(const size_t offset) const{
+                return static_cast<const uint8_t*>(memory) + offset;
+            }
+
+            Entry entry() const{
+                return reinterpret_cast<Entry>(memory);
+            }
+        };
+
+        class Compiler{
+        private:
+            Assembler a;
+            std::vector<size_t> instruction_labels;
+            std::vector<std::function<void()>> slow_paths;
+            size_t exit_ok;
+            size_t exit_error;
+
+            void spill(){
+                a.store(R15, STACK_TOP, R12);
+            }
+
+            void reload(){
+                a.load(R12, R15, STACK_TOP);
+                a.load(R13, R15, STACK_BASE);
+                a.load(R14, R15, STACK_END);
+            }
+
+            void call_helper(const Helper helper, const long long operand){
+                spill();
+                a.mov(RDI, RBX);
+                a.mov(RSI, operand);
+                a.mov(RAX, reinterpret_cast<long long>(helper));
+                a.call(RAX);
+                reload();
+                a.test32(RAX, RAX);
+                a.jcc(Condition::NOT_EQUAL, exit_error);
+            }
+
+            // Out of line helper call, taken when a fast path can't run. Execution resumes at `resume`
+            size_t slow_path(const Helper helper, const long long operand, const size_t resume){
+                const size_t label = a.new_label();
+                slow_paths.push_back([this, label, helper, operand, resume](){
+                    a.bind(label);
+                    call_helper(helper, operand);
+                    a.jmp(resume);
+                });
+                return label;
+            }
+
+            void require_depth(const long long depth, const size_t slow){
+                a.mov(RAX, R12);
+                a.sub(RAX, R13);
+                a.cmp(RAX, static_cast<int32_t>(depth * SLOT));
+                a.jcc(Condition::BELOW, slow);
+            }
+
+            void require_capacity(const size_t slow){
+                a.cmp(R12, R14);
+                a.jcc(Condition::ABOVE_EQUAL, slow);
+            }
+
+            // Charges the stretch starting at target, refuel is a slow path calling helper_refuel
+            void charge(const size_t target, const size_t refuel){
+                a.load(RAX, RBX, FRAME_FUEL);
+                a.sub_memory(RAX, 0, static_cast<int32_t>(std::min<size_t>((*lengths)[target], INT32_MAX)));
+                a.jcc(Condition::LESS, refuel);
+            }
+
+            // Jumps to the instruction after the FLOW_MARK at mark, which is where a metered run charges
+            void transfer(const size_t mark){
+                if(lengths != nullptr){
+                    charge(mark + 1, slow_path(helper_refuel, 0, instruction_labels[mark]));
+                }
+                a.jmp(instruction_labels[mark]);
+            }
+
+            // Jumps to the FLOW_MARK at mark if condition holds and continues with next otherwise
+            void branch(const Condition::Condition condition, const size_t mark, const size_t index){
+                if(lengths == nullptr){
+                    a.jcc(condition, instruction_labels[mark]);
+                    return;
+                }
+                // The charge for the taken branch lives out of line, its refuel slow path has to exist before it is emitted
+                const size_t taken = a.new_label();
+                const size_t refuel = slow_path(helper_refuel, 0, instruction_labels[mark]);
+                slow_paths.push_back([this, taken, refuel, mark](){
+                    a.bind(taken);
+                    charge(mark + 1, refuel);
+                    a.jmp(instruction_labels[mark]);
+                });
+                a.jcc(condition, taken);
+                charge(index + 1, slow_path(helper_refuel, 0, instruction_labels[index + 1]));
+            }
+
+            void binary(const InstructionType::InstructionType type, const Helper helper, const size_t next){
+                require_depth(2, slow_path(helper, 0, next));
+                a.load(RAX, R12, -2*SLOT);
+                a.load(RCX, R12, -SLOT);
+                switch(type){
+                    case InstructionType::ARITHMETIC_ADD:
+                        a.add(RAX, RCX);
+                        break;
+                    case InstructionType::ARITHMETIC_SUB:
+                        a.sub(RAX, RCX);
+                        break;
+                    default:
+                        a.imul(RAX, RCX);
+                        break;
+                }
+                a.store(R12, -2*SLOT, RAX);
+                a.sub(R12, SLOT);
+            }
+
+            void conditional(const Condition::Condition condition, const size_t mark, const size_t index){
+                a.cmp(R12, R13);
+                a.jcc(Condition::EQUAL, slow_path(helper_pop, 0, instruction_labels[index + 1]));   // Always raises ValueStackEmpty
+                a.sub(R12, SLOT);
+                a.load(RAX, R12, 0);
+                a.test(RAX, RAX);
+                branch(condition, mark, index);
+            }
+
+            void immediate(const InstructionType::InstructionType type, const Helper helper, const long long operand, const size_t next){
+                require_depth(1, slow_path(helper, operand, next));
+                a.load(RAX, R12, -SLOT);
+                a.mov(RCX, operand);
+                if(type == InstructionType::ADD_IMM){
+                    a.add(RAX, RCX);
+                }else{
+                    a.sub(RAX, RCX);
+                }
+                a.store(R12, -SLOT, RAX);
+            }
+
+            // Like conditional, but the tested value stays on the stack
+            void conditional_keep(const Condition::Condition condition, const size_t mark, const size_t index){
+                require_depth(1, slow_path(helper_peek, 0, instruction_labels[index + 1]));    // Always raises ValueStackTooSmall
+                a.load(RAX, R12, -SLOT);
+                a.test(RAX, RAX);
+                branch(condition, mark, index);
+            }
+
+            void instruction(const Op& op, const size_t index){
+                const size_t next = instruction_labels[index + 1];
+                switch(op.type){
+                    case InstructionType::STACK_PUSH:
+                        require_capacity(slow_path(helper_push, op.operand, next));
+                        a.mov(RAX, op.operand);
+                        a.store(R12, 0, RAX);
+                        a.add(R12, SLOT);
+                        break;
+                    case InstructionType::STACK_DUP_TOP:
+                    case InstructionType::STACK_DUP_N:{
+                            const long long n = op.type == InstructionType::STACK_DUP_TOP ? 0 : op.operand;
+                            const size_t slow = slow_path(helper_dup_n, n, next);
+                            if(n < 0 || n >= (INT32_MAX / SLOT) - 1){
+                                a.jmp(slow);
+                                break;
+                            }
+                            require_depth(n + 1, slow);
+                            require_capacity(slow);
+                            a.load(RAX, R12, static_cast<int32_t>(-(n + 1) * SLOT));
+                            a.store(R12, 0, RAX);
+                            a.add(R12, SLOT);
+                        }
+                        break;
+                    case InstructionType::STACK_DISCARD_N:
+                        call_helper(helper_discard_n, op.operand);
+                        break;
+                    case InstructionType::STACK_DISCARD_TOP:
+                        require_depth(1, slow_path(helper_discard_top, 0, next));
+                        a.sub(R12, SLOT);
+                        break;
+                    case InstructionType::STACK_SWAP:
+                        require_depth(2, slow_path(helper_swap, 0, next));
+                        a.load(RAX, R12, -SLOT);
+                        a.load(RCX, R12, -2*SLOT);
+                        a.store(R12, -SLOT, RCX);
+                        a.store(R12, -2*SLOT, RAX);
+                        break;
+                    case InstructionType::ARITHMETIC_ADD:
+                        binary(op.type, helper_add, next);
+                        break;
+                    case InstructionType::ARITHMETIC_SUB:
+                        binary(op.type, helper_sub, next);
+                        break;
+                    case InstructionType::ARITHMETIC_MULTIPLICATE:
+                        binary(op.type, helper_multiplicate, next);
+                        break;
+                    case InstructionType::ARITHMETIC_DIVIDE:
+                        call_helper(helper_divide, 0);
+                        break;
+                    case InstructionType::ARITHMETIC_MODULO:
+                        call_helper(helper_modulo, 0);
+                        break;
+                    case InstructionType::HEAP_POP:
+                        call_helper(helper_heap_pop, 0);
+                        break;
+                    case InstructionType::HEAP_PUSH:
+                        call_helper(helper_heap_push, 0);
+                        break;
+                    case InstructionType::OUTPUT_CHAR:
+                        call_helper(helper_output_char, 0);
+                        break;
+                    case InstructionType::OUTPUT_NUM:
+                        call_helper(helper_output_num, 0);
+                        break;
+                    case InstructionType::INPUT_CHAR:
+                        call_helper(helper_input_char, 0);
+                        break;
+                    case InstructionType::INPUT_NUM:
+                        call_helper(helper_input_num, 0);
+                        break;
+                    case InstructionType::FLOW_MARK:
+                        break;
+                    case InstructionType::FLOW_CALL:
+                        call_helper(helper_call, static_cast<long long>(index));
+                        transfer(op.operand);
+                        break;
+                    case InstructionType::FLOW_JUMP_JMP:
+                        transfer(op.operand);
+                        break;
+                    case InstructionType::FLOW_JUMP_EZ:
+                        conditional(Condition::EQUAL, op.operand, index);
+                        break;
+                    case InstructionType::FLOW_JUMP_LZ:
+                        conditional(Condition::LESS, op.operand, index);
+                        break;
+                    case InstructionType::FLOW_RETURN:
+                        call_helper(lengths != nullptr ? helper_return_metered : helper_return, 0);
+                        a.load(RAX, RBX, FRAME_RETURN_INDEX);
+                        a.mov(RCX, return_table);
+                        a.jmp_indexed(RCX, RAX);
+                        break;
+                    case InstructionType::EXIT:
+                        a.jmp(exit_ok);
+                        break;
+                    case InstructionType::UNCLEAN_EXIT:
+                        call_helper(helper_unclean_exit, op.operand);
+                        a.jmp(exit_error);
+                        break;
+                    case InstructionType::ADD_IMM:
+                        immediate(op.type, helper_add_imm, op.operand, next);
+                        break;
+                    case InstructionType::SUB_IMM:
+                        immediate(op.type, helper_sub_imm, op.operand, next);
+                        break;
+                    case InstructionType::SUB_SWAPPED:
+                        require_depth(2, slow_path(helper_sub_swapped, 0, next));
+                        a.load(RAX, R12, -SLOT);
+                        a.load(RCX, R12, -2*SLOT);
+                        a.sub(RAX, RCX);
+                        a.store(R12, -2*SLOT, RAX);
+                        a.sub(R12, SLOT);
+                        break;
+                    case InstructionType::JEZ_KEEP:
+                        conditional_keep(Condition::EQUAL, op.operand, index);
+                        break;
+                    case InstructionType::JLZ_KEEP:
+                        conditional_keep(Condition::LESS, op.operand, index);
+                        break;
+                    case InstructionType::LOAD_IMM_ADDR:
+                        call_helper(helper_heap_load, op.operand);
+                        break;
+                    case InstructionType::STORE_IMM:
+                        call_helper(helper_heap_store_imm, op.operand);
+                        break;
+                    case InstructionType::STORE_TOP_AT_IMM:
+                        call_helper(helper_heap_store_top, op.operand);
+                        break;
+                    default:
+                        call_helper(helper_unknown, op.type);
+                        a.jmp(exit_error);
+                        break;
+                }
+            }
+        public:
+            long long return_table = 0;
+            const std::vector<size_t>* lengths = nullptr;     // Only set for metered runs
+
+            std::vector<uint8_t> compile(const Bytecode& bytecode){
+                const size_t size = bytecode.size();
+                for(size_t i = 0; i <= size; ++i){
+                    instruction_labels.push_back(a.new_label());
+                }
+                exit_ok = a.new_label();
+                exit_error = a.new_label();
+
+                // Prologue, 6 pushes keep rsp 16 byte aligned for helper calls
+                a.push(RBP);
+                a.mov(RBP, RSP);
+                a.push(RBX);
+                a.push(R12);
+                a.push(R13);
+                a.push(R14);
+                a.push(R15);
+                a.sub(RSP, SLOT);
+                a.mov(RBX, RDI);
+                a.mov(R15, RSI);
+                reload();
+
+                for(size_t i = 0; i < size; ++i){
+                    a.bind(instruction_labels[i]);
+                    instruction(bytecode.code[i], i);
+                }
+                a.bind(instruction_labels[size]);   // Never reached, the parser always ends the program with an exit
+                a.jmp(exit_error);
+
+                // Slow paths only ever add slow paths before they are emitted, see branch
+                for(const auto& emit: slow_paths){
+                    emit();
+                }
+
+                a.bind(exit_error);
+                a.mov32(RAX, 1);
+                const size_t epilogue = a.new_label();
+                a.jmp(epilogue);
+                a.bind(exit_ok);
+                a.mov32(RAX, 0);
+                a.bind(epilogue);
+                spill();
+                a.add(RSP, SLOT);
+                a.pop(R15);
+                a.pop(R14);
+                a.pop(R13);
+                a.pop(R12);
+                a.pop(RBX);
+                a.pop(RBP);
+                a.ret();
+
+                a.finalize();
+                return a.code;
+            }
+
+            size_t offset_of_instruction(const size_t index) const{
+                return a.offset_of(instruction_labels[index]);
+            }
+        };
+    }
+
+    bool JIT::supported(){
+        return true;
+    }
+
+    std::shared_ptr<const JIT::NativeCode> JIT::compile_native(const Bytecode& bytecode, const std::vector<size_t>* lengths){
+        // The table's address is baked into the code, so it is allocated before compiling and filled in afterwards
+        const std::shared_ptr<NativeCode> native = std::make_shared<NativeCode>();
+        native->return_targets.resize(bytecode.size());
+
+        Compiler compiler;
+        compiler.return_table = reinterpret_cast<long long>(native->return_targets.data());
+        compiler.lengths = lengths;
+        if(!native->load(compiler.compile(bytecode))){
+            return nullptr;
+        }
+        for(size_t i = 0; i < bytecode.size(); ++i){
+            native->return_targets[i] = native->address(compiler.offset_of_instruction(i + 1));
+        }
+        return native;
+    }
+
+    void interpret_jit(const Bytecode& bytecode, const Prepared& prepared, Input& input, Output& output, const Limits& limits){
+        using namespace JIT;
+
+        if(prepared.native == nullptr){
+            interpret_threaded(bytecode, prepared, input, output, limits);
+            return;
+        }
+
+        Context ctx(limits);
+        std::exception_ptr error;
+        JitFrame frame{0, &ctx, &output, &input, &error, nullptr, nullptr};
+        std::optional<Budget> budget;
+        if(prepared.metered){
+            budget.emplace(prepared.lengths, limits);
+            frame.fuel = &budget->fuel;
+            frame.budget = &*budget;
+            budget->enter(0);
+        }
+
+        if(prepared.native->entry()(&frame, &ctx.values()) != 0){
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+#else
+
+namespace WS{
+    bool JIT::supported(){
+        return false;
+    }
+
+    std::shared_ptr<const JIT::NativeCode> JIT::compile_native(const Bytecode&, const std::vector<size_t>*){
+        return nullptr;
+    }
+
+    void interpret_jit(const Bytecode& bytecode, const Prepared& prepared, Input& input, Output& output, const Limits& limits){
+        interpret_threaded(bytecode, prepared, input, output, limits);
+    }
+}
+
+#endif
@@ -0,0 +1,25 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../bytecode/Bytecode.hpp"
+#include "../interpreter/Input.hpp"
+#include "../interpreter/Output.hpp"
+#include "../interpreter/Prepared.hpp"
+#include "../Options.hpp"
+
+namespace WS{
+    namespace JIT{
+        // True if this build can emit native code (x86-64 with mmap), it can still fail at runtime if the host forbids executable memory
+        bool supported();
+
+        // Compiles the bytecode to x86-64 and maps it read and execute, the mapping goes away with the last reference to it.
+        // With lengths from stretch_lengths the code charges a Budget, without it the code doesn't meter anything.
+        // Null where native code isn't available
+        std::shared_ptr<const NativeCode> compile_native(const Bytecode& bytecode, const std::vector<size_t>* lengths);
+    }
+
+    // Runs prepared.native, falls back to interpret_threaded where it is null
+    void interpret_jit(const Bytecode& bytecode, const Prepared& prepared, Input& input, Output& output, const Limits& limits);
+}
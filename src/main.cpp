@@ -3,52 +3,154 @@
 #include <iostream>
 #include <sstream>
 #include <filesystem>
+#include <optional>
+#include <memory>
 
 #include "whitespace.hpp"
+#include "cli/Arguments.hpp"
+#include "cli/Banners.hpp"
+#include "cli/SourceFile.hpp"
+#include "bytecode/ProgramFile.hpp"
 #include "exceptions/Exceptions.hpp"
 
 
 int main(int argc, char const *argv[]){
     if (argc < 2) {
-        std::cout << "USAGE: whitespace <file.ws> [<Input>...]\n";
+        std::cout << WS::CLI::USAGE;
     }
     else {
-        std::string path = std::filesystem::current_path().string() + '/' + argv[1];
-
-        std::ifstream file = std::ifstream(path);
-        if(!file.is_open()){
-            std::cout << "ERROR: Couldn't open file " + path + '\n';
+        WS::CLI::Arguments arguments;
+        try{
+            arguments = WS::CLI::parse_arguments(argc, argv);
+        }
+        catch(const std::invalid_argument& ex){
+            std::cout << "ERROR: " << ex.what() << '\n' << WS::CLI::USAGE;
             std::exit(1);
         }
 
-        std::stringstream content;
-        content << file.rdbuf();
-        if(file.bad()){
-            file.close();
-            std::cout << "ERROR: Couldn't read file\n";
+        std::string path = std::filesystem::current_path().string() + '/' + arguments.path;
+
+        std::optional<WS::CLI::SourceFile> file;
+        try{
+            file.emplace(path);
+        }
+        catch(const std::runtime_error& ex){
+            std::cout << "ERROR: " << ex.what() << '\n';
             std::exit(1);
         }
+        const std::string_view content = file->content();
+
+        // .wsc images skip the front end, they are recognized by their magic so the extension doesn't matter
+        const bool is_image = WS::ProgramFile::is_image(content);
+        const auto load = [&](){
+            return is_image ? WS::load_program(content, arguments.options) : WS::compile_program(content, arguments.options);
+        };
         
-        std::string input;
-        for(int i = 2; i < argc; ++i){
-            input += std::string(argv[i]) + '\n';
+        if(!arguments.emit_c_path.empty()){
+            if(is_image){
+                std::cout << "ERROR: --emit-c needs a whitespace source, not a .wsc image\n";
+                std::exit(1);
+            }
+            std::stringstream translation;
+            try{
+                WS::emit_c(content, translation, arguments.options.limits.call_depth);
+            }
+            catch(const WS::WhitespaceCompileError& ex){
+                std::cout << WS::CLI::Banners::COMPILATION_ERROR << ex.what() << '\n';
+                std::exit(1);
+            }
+
+            std::ofstream output = std::ofstream(arguments.emit_c_path);
+            if(!output.is_open()){
+                std::cout << "ERROR: Couldn't open file " + arguments.emit_c_path + '\n';
+                std::exit(1);
+            }
+            output << translation.rdbuf();
+            return 0;
+        }
+
+        if(!arguments.compile_path.empty()){
+            std::stringstream image;
+            try{
+                WS::save_program(load(), image);
+            }
+            catch(const WS::WhitespaceCompileError& ex){
+                std::cout << WS::CLI::Banners::COMPILATION_ERROR << ex.what() << '\n';
+                std::exit(1);
+            }
+
+            std::ofstream output = std::ofstream(arguments.compile_path, std::ios::binary);
+            if(!output.is_open()){
+                std::cout << "ERROR: Couldn't open file " + arguments.compile_path + '\n';
+                std::exit(1);
+            }
+            output << image.rdbuf();
+            return 0;
         }
 
+        if(arguments.dump_ir){
+            try{
+                WS::dump_ir(load(), std::cout);
+            }
+            catch(const WS::WhitespaceCompileError& ex){
+                std::cout << WS::CLI::Banners::COMPILATION_ERROR << ex.what() << '\n';
+                std::exit(1);
+            }
+            return 0;
+        }
+
+        std::unique_ptr<WS::Input> input;
+        if(arguments.read_stdin){
+            input = std::make_unique<WS::FileInput>(stdin);
+        }
+        else{
+            std::string joined;
+            for(const std::string& argument: arguments.inputs){
+                joined += argument + '\n';
+            }
+            input = std::make_unique<WS::StringInput>(std::move(joined));
+        }
+
+        // The program output goes straight to the file descriptor while it runs, the banners around it through std::cout
+        std::ofstream folded;
+        if(!arguments.folded_path.empty()){
+            folded.open(arguments.folded_path);
+            if(!folded.is_open()){
+                std::cout << "ERROR: Couldn't open file " + arguments.folded_path + '\n';
+                std::exit(1);
+            }
+        }
+
+        WS::FileOutput output(stdout);
+        input->tie(&output);    // Interactive programs under --stdin get to show their prompts before waiting
+        std::ostringstream report;
         try{
-        std::cout << "~~~~~RESULT~~~~~\n" << WS::whitespace(content.str(), input) << '\n';
+        std::cout << WS::CLI::Banners::RESULT << std::flush;
+        if(arguments.profile){
+            WS::profile(load(), *input, output, report, folded.is_open() ? &folded : nullptr);
+        }
+        else{
+            WS::run(load(), *input, output);
+        }
+        std::cout << '\n';
         }
         catch(const WS::WhitespaceRuntimeException& ex){
-            std::cout << "~~~RUNTIME EXCEPTION~~~\n" << ex.what() << '\n';
+            std::cout << (output.empty() ? "" : "\n") << WS::CLI::Banners::RUNTIME_EXCEPTION << ex.what() << '\n';
         }
         catch(const WS::WhitespaceCompileError& ex){
-            std::cout << "~~~COMPILATION ERROR~~~\n" << ex.what() << '\n';
+            std::cout << WS::CLI::Banners::COMPILATION_ERROR << ex.what() << '\n';
         }
         catch(const std::exception &ex){
-            std::cout << "~~~C++ EXCEPTION~~~\n" << ex.what() << '\n';
+            std::cout << (output.empty() ? "" : "\n") << WS::CLI::Banners::CPP_EXCEPTION << ex.what() << '\n';
         }
         catch(...){
-            std::cout << "~~~UNKNOWN ERROR~~~\n" << '\n';
+            std::cout << (output.empty() ? "" : "\n") << WS::CLI::Banners::UNKNOWN_ERROR << '\n';
+        }
+        // The report is written even when the program raised, it comes after everything the run printed
+        if(arguments.profile && report.tellp() > 0){
+            std::cout << std::flush;
+            std::cerr << WS::CLI::Banners::PROFILE << report.str();
         }
     }
     return 0;
-}
\ No newline at end of file
+}
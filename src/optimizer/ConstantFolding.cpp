@@ -0,0 +1,127 @@
+#include <optional>
+
+#include "Optimizer.hpp"
+#include "ControlFlow.hpp"
+#include "../interpreter/Operations.hpp"
+
+namespace WS{
+    class Folder{
+    private:
+        std::vector<Op> code;
+        std::vector<SourceSpan> spans;
+        size_t constants = 0;       // Trailing STACK_PUSHes emitted since the current block began
+
+        const Op& constant(const size_t from_top) const{
+            return code[code.size() - 1 - from_top];
+        }
+
+        void drop_constant(){
+            code.pop_back();
+            spans.pop_back();
+            --constants;
+        }
+
+    public:
+        Folder(const size_t size){
+            code.reserve(size);
+            spans.reserve(size);
+        }
+
+        void block_begins(){
+            constants = 0;
+        }
+
+        void emit(const Op& op, const SourceSpan& span){
+            code.push_back(op);
+            spans.push_back(span);
+            constants = op.type == InstructionType::STACK_PUSH ? constants + 1 : 0;
+        }
+
+        // Folds op into the constants on top of the stack, false if it has to be emitted as is
+        bool absorb(const Op& op, const SourceSpan& span){
+            switch(op.type){
+                case InstructionType::ARITHMETIC_ADD:
+                case InstructionType::ARITHMETIC_SUB:
+                case InstructionType::ARITHMETIC_MULTIPLICATE:
+                case InstructionType::ARITHMETIC_DIVIDE:
+                case InstructionType::ARITHMETIC_MODULO:{
+                        if(constants < 2){
+                            return false;
+                        }
+                        const std::optional<long long> value = Operations::checked(op.type, constant(1).operand, constant(0).operand);
+                        if(!value){
+                            return false;
+                        }
+                        const size_t from = spans[spans.size() - 2].from;
+                        drop_constant();
+                        drop_constant();
+                        emit(Op{InstructionType::STACK_PUSH, *value}, SourceSpan{from, span.to});
+                        return true;
+                    }
+                case InstructionType::STACK_DUP_TOP:{
+                        if(constants < 1){
+                            return false;
+                        }
+                        const Op top = constant(0);     // emit may reallocate code
+                        emit(top, span);
+                        return true;
+                    }
+                case InstructionType::STACK_DISCARD_TOP:
+                    if(constants < 1){
+                        return false;
+                    }
+                    drop_constant();
+                    return true;
+                case InstructionType::STACK_SWAP:
+                    if(constants < 2){
+                        return false;
+                    }
+                    std::swap(code[code.size() - 1], code[code.size() - 2]);
+                    std::swap(spans[spans.size() - 1], spans[spans.size() - 2]);
+                    return true;
+                case InstructionType::FLOW_JUMP_EZ:
+                case InstructionType::FLOW_JUMP_LZ:{
+                        if(constants < 1){
+                            return false;
+                        }
+                        const long long value = constant(0).operand;
+                        const bool taken = op.type == InstructionType::FLOW_JUMP_EZ ? value == 0 : value < 0;
+                        drop_constant();
+                        if(taken){
+                            emit(Op{InstructionType::FLOW_JUMP_JMP, op.operand}, span);
+                        }
+                        return true;
+                    }
+                default:
+                    return false;
+            }
+        }
+
+        Bytecode finish(const std::vector<size_t>& new_index){
+            retarget(code, new_index);
+            return Bytecode(std::move(code), std::move(spans));
+        }
+
+        size_t size() const{
+            return code.size();
+        }
+    };
+
+    Bytecode fold_constants(const Bytecode& bytecode){
+        const std::vector<bool> leaders = block_leaders(bytecode);
+        std::vector<size_t> new_index(bytecode.size(), 0);
+        Folder folder(bytecode.size());
+
+        for(size_t i = 0; i < bytecode.size(); ++i){
+            if(leaders[i]){
+                folder.block_begins();
+            }
+            new_index[i] = folder.size();
+            if(!folder.absorb(bytecode.code[i], bytecode.spans[i])){
+                folder.emit(bytecode.code[i], bytecode.spans[i]);
+            }
+        }
+
+        return folder.finish(new_index);
+    }
+}
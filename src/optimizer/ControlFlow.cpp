@@ -0,0 +1,89 @@
+#include "ControlFlow.hpp"
+
+namespace WS{
+    ControlFlowGraph::ControlFlowGraph(std::vector<BasicBlock>&& blocks, std::vector<size_t>&& block_of): blocks(std::move(blocks)), block_of(std::move(block_of)){}
+
+    std::vector<bool> ControlFlowGraph::reachable() const{
+        std::vector<bool> result(blocks.size(), false);
+        if(blocks.empty()){
+            return result;
+        }
+
+        std::vector<size_t> pending = {0};
+        result[0] = true;
+        while(!pending.empty()){
+            const size_t block = pending.back();
+            pending.pop_back();
+            for(const size_t successor: blocks[block].successors){
+                if(!result[successor]){
+                    result[successor] = true;
+                    pending.push_back(successor);
+                }
+            }
+        }
+        return result;
+    }
+
+    bool ends_block(const InstructionType::InstructionType type){
+        switch(type){
+            case InstructionType::FLOW_RETURN:
+            case InstructionType::EXIT:
+            case InstructionType::UNCLEAN_EXIT:
+                return true;
+            default:
+                return has_target(type);
+        }
+    }
+
+    std::vector<bool> block_leaders(const Bytecode& bytecode){
+        std::vector<bool> leaders(bytecode.size(), false);
+        for(size_t i = 0; i < bytecode.size(); ++i){
+            const InstructionType::InstructionType type = bytecode.code[i].type;
+            if(i == 0 || type == InstructionType::FLOW_MARK){
+                leaders[i] = true;
+            }
+            if(ends_block(type) && i + 1 < bytecode.size()){
+                leaders[i + 1] = true;
+            }
+        }
+        return leaders;
+    }
+
+    ControlFlowGraph control_flow_graph(const Bytecode& bytecode){
+        const std::vector<bool> leaders = block_leaders(bytecode);
+        std::vector<BasicBlock> blocks;
+        std::vector<size_t> block_of(bytecode.size(), 0);
+
+        for(size_t i = 0; i < bytecode.size(); ++i){
+            if(leaders[i]){
+                if(!blocks.empty()){
+                    blocks.back().end = i;
+                }
+                blocks.push_back(BasicBlock{i, bytecode.size(), {}});
+            }
+            block_of[i] = blocks.size() - 1;
+        }
+
+        for(size_t b = 0; b < blocks.size(); ++b){
+            const Op& last = bytecode.code[blocks[b].end - 1];
+            const bool has_next = b + 1 < blocks.size();
+
+            if(has_target(last.type)){
+                blocks[b].successors.push_back(block_of[last.operand]);
+            }
+            switch(last.type){
+                case InstructionType::FLOW_JUMP_JMP:
+                case InstructionType::FLOW_RETURN:
+                case InstructionType::EXIT:
+                case InstructionType::UNCLEAN_EXIT:
+                    break;
+                default:
+                    if(has_next){
+                        blocks[b].successors.push_back(b + 1);
+                    }
+            }
+        }
+
+        return ControlFlowGraph(std::move(blocks), std::move(block_of));
+    }
+}
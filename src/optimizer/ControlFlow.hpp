@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../bytecode/Bytecode.hpp"
+
+namespace WS{
+    // Instructions [begin, end) that are only ever entered at begin and only left after end-1
+    struct BasicBlock{
+        size_t begin;
+        size_t end;
+        std::vector<size_t> successors;     // Block indices, a FLOW_CALL's return site counts as one of its successors
+    };
+
+    class ControlFlowGraph{
+    public:
+        const std::vector<BasicBlock> blocks;
+        const std::vector<size_t> block_of;     // Instruction index -> block index
+
+        ControlFlowGraph() = delete;
+        ControlFlowGraph(std::vector<BasicBlock>&& blocks, std::vector<size_t>&& block_of);
+        ControlFlowGraph(const ControlFlowGraph&) = default;
+        ControlFlowGraph(ControlFlowGraph&&) = default;
+        ControlFlowGraph& operator=(const ControlFlowGraph&) = delete;
+        ControlFlowGraph& operator=(ControlFlowGraph&&) = delete;
+
+        // Blocks reachable from the first instruction
+        std::vector<bool> reachable() const;
+    };
+
+    // Whether execution never simply continues with the next instruction
+    bool ends_block(const InstructionType::InstructionType type);
+
+    // Instructions that start a basic block: the first one, every FLOW_MARK and everything after ends_block
+    std::vector<bool> block_leaders(const Bytecode& bytecode);
+
+    ControlFlowGraph control_flow_graph(const Bytecode& bytecode);
+}
@@ -0,0 +1,27 @@
+#include "Optimizer.hpp"
+#include "ControlFlow.hpp"
+
+namespace WS{
+    Bytecode eliminate_dead_code(const Bytecode& bytecode){
+        const ControlFlowGraph graph = control_flow_graph(bytecode);
+        const std::vector<bool> reachable = graph.reachable();
+
+        std::vector<Op> code;
+        std::vector<SourceSpan> spans;
+        std::vector<size_t> new_index(bytecode.size(), 0);
+        code.reserve(bytecode.size());
+        spans.reserve(bytecode.size());
+
+        for(size_t i = 0; i < bytecode.size(); ++i){
+            if(!reachable[graph.block_of[i]]){
+                continue;
+            }
+            new_index[i] = code.size();
+            code.push_back(bytecode.code[i]);
+            spans.push_back(bytecode.spans[i]);
+        }
+
+        retarget(code, new_index);
+        return Bytecode(std::move(code), std::move(spans));
+    }
+}
@@ -0,0 +1,15 @@
+#include "Optimizer.hpp"
+
+namespace WS{
+    Bytecode optimize(const Bytecode& bytecode){
+        return fuse_superinstructions(eliminate_dead_code(fold_constants(bytecode)));
+    }
+
+    void retarget(std::vector<Op>& code, const std::vector<size_t>& new_index){
+        for(Op& op: code){
+            if(has_target(op.type)){
+                op.operand = static_cast<long long>(new_index[op.operand]);
+            }
+        }
+    }
+}
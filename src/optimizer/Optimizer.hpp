@@ -0,0 +1,23 @@
+#pragma once
+
+#include "../bytecode/Bytecode.hpp"
+
+namespace WS{
+    // Runs every optimization pass, the result prints the same and raises the same exceptions as the input.
+    // Limits are the exception: they apply to the optimized program, whose folded and fused sequences no longer push
+    // their temporaries, so it may stay within a Limits::stack_depth the input breaks, and a superinstruction is charged
+    // once against Limits::instructions. Run the unoptimized bytecode to meter the program as written
+    Bytecode optimize(const Bytecode& bytecode);
+
+    // Evaluates STACK_PUSH / ARITHMETIC_* chains and branches on constants inside each basic block
+    Bytecode fold_constants(const Bytecode& bytecode);
+
+    // Drops every basic block that can't be reached from the first instruction
+    Bytecode eliminate_dead_code(const Bytecode& bytecode);
+
+    // Replaces common instruction sequences with a single superinstruction
+    Bytecode fuse_superinstructions(const Bytecode& bytecode);
+
+    // Points every branch of a pass' output at new_index[old target], targets are always FLOW_MARKs
+    void retarget(std::vector<Op>& code, const std::vector<size_t>& new_index);
+}
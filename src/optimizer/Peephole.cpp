@@ -0,0 +1,76 @@
+#include "Optimizer.hpp"
+
+namespace WS{
+    struct Fusion{
+        InstructionType::InstructionType type;
+        long long operand;
+        size_t length;      // Number of instructions replaced, 0 if nothing matched
+    };
+
+    bool matches(const std::vector<Op>& code, const size_t index, std::initializer_list<InstructionType::InstructionType> pattern){
+        if(index + pattern.size() > code.size()){
+            return false;
+        }
+        size_t i = index;
+        for(const InstructionType::InstructionType type: pattern){
+            if(code[i++].type != type){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Longest patterns first. None of them contain a FLOW_MARK, so no jump can land inside a fused sequence
+    Fusion fusion_at(const std::vector<Op>& code, const size_t i){
+        using namespace InstructionType;
+
+        if(matches(code, i, {STACK_PUSH, STACK_SWAP, HEAP_POP})){
+            return Fusion{STORE_TOP_AT_IMM, code[i].operand, 3};
+        }
+        if(matches(code, i, {STACK_PUSH, ARITHMETIC_ADD})){
+            return Fusion{ADD_IMM, code[i].operand, 2};
+        }
+        if(matches(code, i, {STACK_PUSH, ARITHMETIC_SUB})){
+            return Fusion{SUB_IMM, code[i].operand, 2};
+        }
+        if(matches(code, i, {STACK_PUSH, HEAP_PUSH})){
+            return Fusion{LOAD_IMM_ADDR, code[i].operand, 2};
+        }
+        if(matches(code, i, {STACK_PUSH, HEAP_POP})){
+            return Fusion{STORE_IMM, code[i].operand, 2};
+        }
+        if(matches(code, i, {STACK_SWAP, ARITHMETIC_SUB})){
+            return Fusion{SUB_SWAPPED, 0, 2};
+        }
+        if(matches(code, i, {STACK_DUP_TOP, FLOW_JUMP_EZ})){
+            return Fusion{JEZ_KEEP, code[i + 1].operand, 2};
+        }
+        if(matches(code, i, {STACK_DUP_TOP, FLOW_JUMP_LZ})){
+            return Fusion{JLZ_KEEP, code[i + 1].operand, 2};
+        }
+        return Fusion{code[i].type, code[i].operand, 0};
+    }
+
+    Bytecode fuse_superinstructions(const Bytecode& bytecode){
+        const std::vector<Op>& code = bytecode.code;
+        std::vector<Op> fused;
+        std::vector<SourceSpan> spans;
+        std::vector<size_t> new_index(code.size(), 0);     // Only valid for the first instruction of every sequence
+        fused.reserve(code.size());
+        spans.reserve(code.size());
+
+        for(size_t i = 0; i < code.size();){
+            const Fusion fusion = fusion_at(code, i);
+            const size_t length = fusion.length == 0 ? 1 : fusion.length;
+
+            new_index[i] = fused.size();
+            fused.push_back(fusion.length == 0 ? code[i] : Op{fusion.type, fusion.operand});
+            spans.push_back(SourceSpan{bytecode.spans[i].from, bytecode.spans[i + length - 1].to});
+            i += length;
+        }
+
+        retarget(fused, new_index);
+
+        return Bytecode(std::move(fused), std::move(spans));
+    }
+}
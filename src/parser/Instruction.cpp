@@ -1,26 +1,7 @@
 #include "Instruction.hpp"
 
 namespace WS{
-    Label::Label(const std::vector<Token>& tokens): tokens(tokens){}
-
-    Label::operator std::string() const{
-        std::string result;
-        for(auto& token: tokens){
-                result += char(token);
-        }
-        return result;
-    }
-
-    bool operator==(const Label &lhs, const Label &rhs)
-    {
-        return std::string(lhs) == std::string(rhs);
-    }
-
-    std::ostream &operator<<(std::ostream &stream, const Label &label)
-    {
-        stream << std::string(label);
-        return stream;
-    }
+    Label::Label(const uint32_t id): id(id){}
 
     std::string range(const size_t& from, const size_t& to){
         std::string result = std::to_string(from);
@@ -29,147 +10,48 @@ namespace WS{
         return result;
     }
 
-    Instruction::Instruction(InstructionType::InstructionType type, const size_t& from, const size_t& to): type(type), from(from), to(to){}
-    Instruction::Instruction(InstructionType::InstructionType type, const size_t& from, const size_t& to, const Label& label): type(type), from(from), to(to), value(label){}
-    Instruction::Instruction(InstructionType::InstructionType type, const size_t& from, const size_t& to, const long long& number): type(type), from(from), to(to), value(number){}
-
-
-
-    Instruction::operator std::string() const{
-        std::string result;
-        constexpr char middle[] = "]->(";
-
-        result += '[';
+    const char* instruction_name(const InstructionType::InstructionType type){
         switch(type){
-            case InstructionType::STACK_PUSH:
-                result += "STACK::PUSH: ";
-                result += range(from, to) + middle;
-                result += std::to_string(std::get<const long long>(*value)) + ')';;
-                return result;  
-            case InstructionType::STACK_DUP_N:
-                result += "STACK::DUP::N: ";
-                result += range(from, to) + middle;
-                result += std::to_string(std::get<const long long>(*value)) + ')';
-                return result; 
-            case InstructionType::STACK_DISCARD_N:
-                result += "STACK::DISCARD::N: ";
-                result += range(from, to) + middle;
-                result += std::to_string(std::get<const long long>(*value)) + ')';
-                return result;
-            case InstructionType::STACK_DUP_TOP:
-                result += "STACK::DUP::TOP: ";
-                result += range(from, to) + ']';
-                return result;
-            case InstructionType::STACK_SWAP:
-                result += "STACK::SWAP: ";
-                result += range(from, to) + ']';
-                return result;
-            case InstructionType::STACK_DISCARD_TOP:
-                result += "STACK::DISCARD::TOP: ";
-                result += range(from, to) + ']';
-                return result;
-
-            case InstructionType::ARITHMETIC_ADD:
-                result += "ARITHMETIC::ADD: ";
-                result += range(from, to) + ']';
-                return result;
-            case InstructionType::ARITHMETIC_SUB:
-                result += "ARITHMETIC::SUB: ";
-                result += range(from, to) + ']';
-                return result;
-            case InstructionType::ARITHMETIC_MULTIPLICATE:
-                result += "ARITHMETIC::MULTIPLICATE: ";
-                result += range(from, to) + ']';
-                return result;
-            case InstructionType::ARITHMETIC_DIVIDE:
-                result += "ARITHMETIC::DIVIDE: ";
-                result += range(from, to) + ']';
-                return result;
-            case InstructionType::ARITHMETIC_MODULO:
-                result += "ARITHMETIC::MODULO: ";
-                result += range(from, to) + ']';
-                return result;
-            
-            case InstructionType::HEAP_POP:
-                result += "HEAP::POP: ";
-                result += range(from, to) + ']';
-                return result;
-            
-            case InstructionType::HEAP_PUSH:
-                result += "HEAP::PUSH: ";
-                result += range(from, to) + ']';
-                return result;
-            
-            case InstructionType::OUTPUT_CHAR:
-                result += "OUTPUT::CHAR: ";
-                result += range(from, to) + ']';
-                return result;
-            case InstructionType::OUTPUT_NUM:
-                result += "OUTPUT::NUM: ";
-                result += range(from, to) + ']';
-                return result;
-
-            case InstructionType::INPUT_CHAR:
-                result += "INPUT::CHAR: ";
-                result += range(from, to) + ']';
-                return result;
-            case InstructionType::INPUT_NUM:
-                result += "INPUT::NUM: ";
-                result += range(from, to) + ']';
-                return result;
-            
-            case InstructionType::FLOW_MARK:
-                result += "FLOW::MARK: ";
-                result += range(from, to) + middle;
-                result += std::string(std::get<const Label>(*value)) + ')';
-                return result;
-            case InstructionType::FLOW_CALL:
-                result += "FLOW::CALL: ";
-                result += range(from, to) + middle;
-                result += std::string(std::get<const Label>(*value)) + ')';
-                return result;
-            case InstructionType::FLOW_JUMP_JMP:
-                result += "FLOW::JUMP::JMP: ";
-                result += range(from, to) + middle;
-                result += std::string(std::get<const Label>(*value)) + ')';
-                return result;
-            case InstructionType::FLOW_JUMP_EZ:
-                result += "FLOW::JUMP::EZ: ";
-                result += range(from, to) + middle;
-                result += std::string(std::get<const Label>(*value)) + ')';
-                return result;
-            case InstructionType::FLOW_JUMP_LZ:
-                result += "FLOW::JUMP::LZ: ";
-                result += range(from, to) + middle;
-                result += std::string(std::get<const Label>(*value)) + ')';
-                return result;
-            case InstructionType::FLOW_RETURN:
-                result += "FLOW::RETURN: ";
-                result += range(from, to) + ']';
-                return result;
-            
-            case InstructionType::EXIT:
-                result += "EXIT: ";
-                result += range(from, to) + ']';
-                return result;
-
-            case InstructionType::UNCLEAN_EXIT:
-                result += "UNCLEAN::EXIT: ";
-                result += range(from, to) + ']';
-                return result;
-            
-            default:
-                result += "?: ";
-                result += range(from, to) + ']';
-                return result;
+            case InstructionType::STACK_PUSH: return "STACK::PUSH";
+            case InstructionType::STACK_DUP_N: return "STACK::DUP::N";
+            case InstructionType::STACK_DISCARD_N: return "STACK::DISCARD::N";
+            case InstructionType::STACK_DUP_TOP: return "STACK::DUP::TOP";
+            case InstructionType::STACK_SWAP: return "STACK::SWAP";
+            case InstructionType::STACK_DISCARD_TOP: return "STACK::DISCARD::TOP";
+            case InstructionType::ARITHMETIC_ADD: return "ARITHMETIC::ADD";
+            case InstructionType::ARITHMETIC_SUB: return "ARITHMETIC::SUB";
+            case InstructionType::ARITHMETIC_MULTIPLICATE: return "ARITHMETIC::MULTIPLICATE";
+            case InstructionType::ARITHMETIC_DIVIDE: return "ARITHMETIC::DIVIDE";
+            case InstructionType::ARITHMETIC_MODULO: return "ARITHMETIC::MODULO";
+            case InstructionType::HEAP_POP: return "HEAP::POP";
+            case InstructionType::HEAP_PUSH: return "HEAP::PUSH";
+            case InstructionType::OUTPUT_CHAR: return "OUTPUT::CHAR";
+            case InstructionType::OUTPUT_NUM: return "OUTPUT::NUM";
+            case InstructionType::INPUT_CHAR: return "INPUT::CHAR";
+            case InstructionType::INPUT_NUM: return "INPUT::NUM";
+            case InstructionType::FLOW_MARK: return "FLOW::MARK";
+            case InstructionType::FLOW_CALL: return "FLOW::CALL";
+            case InstructionType::FLOW_JUMP_JMP: return "FLOW::JUMP::JMP";
+            case InstructionType::FLOW_JUMP_EZ: return "FLOW::JUMP::EZ";
+            case InstructionType::FLOW_JUMP_LZ: return "FLOW::JUMP::LZ";
+            case InstructionType::FLOW_RETURN: return "FLOW::RETURN";
+            case InstructionType::EXIT: return "EXIT";
+            case InstructionType::UNCLEAN_EXIT: return "UNCLEAN::EXIT";
+            case InstructionType::ADD_IMM: return "FUSED::ADD::IMM";
+            case InstructionType::SUB_IMM: return "FUSED::SUB::IMM";
+            case InstructionType::SUB_SWAPPED: return "FUSED::SUB::SWAPPED";
+            case InstructionType::JEZ_KEEP: return "FUSED::JUMP::EZ::KEEP";
+            case InstructionType::JLZ_KEEP: return "FUSED::JUMP::LZ::KEEP";
+            case InstructionType::LOAD_IMM_ADDR: return "FUSED::LOAD::IMM";
+            case InstructionType::STORE_IMM: return "FUSED::STORE::IMM";
+            case InstructionType::STORE_TOP_AT_IMM: return "FUSED::STORE::TOP";
+            default: return "?";
         }
     }
 
-    
-
-    std::ostream &operator<<(std::ostream &stream, const Instruction &command)
-    {
-        stream << std::string(command);
-        return stream;
-    }
-}
\ No newline at end of file
+    Instruction::Instruction(InstructionType::InstructionType type, const size_t& from, const size_t& to): type(type), from(from), to(to), target(0){}
+    Instruction::Instruction(InstructionType::InstructionType type, const size_t& from, const size_t& to, const Label& label): type(type), from(from), to(to), value(label), target(0){}
+    Instruction::Instruction(InstructionType::InstructionType type, const size_t& from, const size_t& to, const long long& number): type(type), from(from), to(to), value(number), target(0){}
+    Instruction::Instruction(InstructionType::InstructionType type, const size_t& from, const size_t& to, const BigInt& number): type(type), from(from), to(to), value(number), target(0){}
+    Instruction::Instruction(const Instruction& command, const size_t& target): type(command.type), from(command.from), to(command.to), value(command.value), target(target){}
+}
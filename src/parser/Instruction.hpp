@@ -1,31 +1,27 @@
 #pragma once
 #include <variant>
+#include <vector>
 
 #include "../tokenizer/Tokenizer.hpp"
+#include "LabelTable.hpp"
+#include "../bignum/BigInt.hpp"
 
 namespace WS{
+    // A label by its id in the program's LabelTable, equal labels share the id
     class Label{
     public:
-        const std::vector<Token> tokens;
+        const uint32_t id;
 
         Label() = delete;
-        Label(const std::vector<Token>& tokens);
+        Label(const uint32_t id);
         Label(const Label& label) = default;
         Label(Label&& label) = default;
         Label& operator=(const Label&) = delete;
         Label& operator=(Label&&) = delete;
-
-        operator std::string() const;
-
-        friend bool operator==(const Label& lhs,const Label& rhs);
-        friend std::ostream& operator<<(std::ostream& stream, const Label& label);
     };
 
-    struct LabelHash{
-        size_t operator()(const Label& label) const noexcept{
-            return std::hash<std::string>{}(label);
-        }
-    };
+
+    std::string range(const size_t& from, const size_t& to);
 
 
     namespace InstructionType{
@@ -60,29 +56,42 @@ namespace WS{
             FLOW_RETURN,
 
             EXIT,
-            UNCLEAN_EXIT
+            UNCLEAN_EXIT,
+
+            // Superinstructions, only produced by the optimizer
+            ADD_IMM,            // STACK_PUSH n; ARITHMETIC_ADD
+            SUB_IMM,            // STACK_PUSH n; ARITHMETIC_SUB
+            SUB_SWAPPED,        // STACK_SWAP; ARITHMETIC_SUB
+            JEZ_KEEP,           // STACK_DUP_TOP; FLOW_JUMP_EZ
+            JLZ_KEEP,           // STACK_DUP_TOP; FLOW_JUMP_LZ
+            LOAD_IMM_ADDR,      // STACK_PUSH addr; HEAP_PUSH
+            STORE_IMM,          // STACK_PUSH n; HEAP_POP
+            STORE_TOP_AT_IMM,   // STACK_PUSH addr; STACK_SWAP; HEAP_POP
         };
     }
 
 
+    // Name as used in listings, e.g. "STACK::PUSH"
+    const char* instruction_name(const InstructionType::InstructionType type);
+
+
     class Instruction{
     public:
         const InstructionType::InstructionType type;
         const size_t from;
         const size_t to;
-        const std::optional<std::variant<const Label, const long long>> value;
+        const std::optional<std::variant<const Label, const long long, const BigInt>> value;     // BigInt only for STACK_PUSH literals that don't fit a long long
+        const size_t target;
 
         Instruction() = delete;
         Instruction(InstructionType::InstructionType type, const size_t& from, const size_t& to);
         Instruction(InstructionType::InstructionType type, const size_t& from, const size_t& to, const Label& label);
         Instruction(InstructionType::InstructionType type, const size_t& from, const size_t& to, const long long& number);
+        Instruction(InstructionType::InstructionType type, const size_t& from, const size_t& to, const BigInt& number);
+        Instruction(const Instruction& command, const size_t& target);
         Instruction(const Instruction& command) = default;
         Instruction(Instruction&& command) = default;
         Instruction& operator=(const Instruction&) = delete;
         Instruction& operator=(Instruction&&) = delete;
-
-        operator std::string() const;
-
-        friend std::ostream& operator<<(std::ostream& stream, const Instruction& command);
     };
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include <algorithm>
+
+#include "LabelTable.hpp"
+
+namespace WS{
+    LabelTable::LabelTable(): nodes{TrieNode{{ROOT, ROOT}, ROOT, NO_LABEL, false}}{}
+
+    LabelTable::Node LabelTable::step(const Node node, const bool bit){
+        const Node child = nodes[node].children[bit];
+        if(child != ROOT){
+            return child;
+        }
+
+        const Node created = static_cast<Node>(nodes.size());
+        nodes.push_back(TrieNode{{ROOT, ROOT}, node, NO_LABEL, bit});
+        nodes[node].children[bit] = created;
+        return created;
+    }
+
+    void LabelTable::reserve(const size_t count){
+        nodes.reserve(count + 1);
+    }
+
+    uint32_t LabelTable::intern(const Node node){
+        if(nodes[node].label == NO_LABEL){
+            nodes[node].label = static_cast<uint32_t>(label_nodes.size());
+            label_nodes.push_back(node);
+        }
+        return nodes[node].label;
+    }
+
+    std::string LabelTable::name(const uint32_t id) const{
+        std::string result;
+        for(Node node = label_nodes[id]; node != ROOT; node = nodes[node].parent){
+            result += nodes[node].bit ? 'T' : 'S';
+        }
+        std::reverse(result.begin(), result.end());
+        result += 'N';
+        return result;
+    }
+
+    void LabelTable::write_name(const uint32_t id, std::ostream& output) const{
+        constexpr size_t CHUNK = 64;
+        size_t depth = 0;
+        for(Node node = label_nodes[id]; node != ROOT; node = nodes[node].parent){
+            ++depth;
+        }
+
+        // The bits come out last one first, so every chunk of the name walks up from the end of the label on its own
+        char chunk[CHUNK];
+        for(size_t written = 0; written < depth; written += CHUNK){
+            const size_t count = std::min(CHUNK, depth - written);
+            Node node = label_nodes[id];
+            for(size_t skip = depth - written - count; skip > 0; --skip){
+                node = nodes[node].parent;
+            }
+            for(size_t i = count; i-- > 0; node = nodes[node].parent){
+                chunk[i] = nodes[node].bit ? 'T' : 'S';
+            }
+            output.write(chunk, static_cast<std::streamsize>(count));
+        }
+        output.put('N');
+    }
+
+    size_t LabelTable::size() const{
+        return label_nodes.size();
+    }
+}
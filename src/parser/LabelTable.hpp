@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace WS{
+    // Gives every distinct label of a program a dense id, in order of first appearance.
+    // The bit patterns live in a binary trie, so interning walks the bits once as they are parsed
+    // and the name of an id, only needed for diagnostics, is rebuilt by walking back up
+    class LabelTable{
+    public:
+        using Node = uint32_t;
+        static constexpr Node ROOT = 0;
+        static constexpr uint32_t NO_LABEL = UINT32_MAX;
+
+    private:
+        struct TrieNode{
+            Node children[2];       // ROOT if there is none, the root is nobody's child
+            Node parent;
+            uint32_t label;         // NO_LABEL unless a label ends here
+            bool bit;
+        };
+
+        std::vector<TrieNode> nodes;
+        std::vector<Node> label_nodes;      // Id -> the node the label ends at
+
+    public:
+        LabelTable();
+
+        // The node one bit (SPACE = false, TAB = true) below node, created on first use
+        Node step(const Node node, const bool bit);
+
+        // Makes room for nodes trie nodes, at most one per bit of all labels
+        void reserve(const size_t nodes);
+
+        // The id of the label whose bits lead to node
+        uint32_t intern(const Node node);
+
+        // The label as written, e.g. "STN"
+        std::string name(const uint32_t id) const;
+
+        // Writes name(id) without building it
+        void write_name(const uint32_t id, std::ostream& output) const;
+
+        size_t size() const;
+    };
+}
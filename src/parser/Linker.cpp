@@ -0,0 +1,37 @@
+#include "Linker.hpp"
+
+namespace WS{
+    bool is_branch(const InstructionType::InstructionType type){
+        switch(type){
+            case InstructionType::FLOW_CALL:
+            case InstructionType::FLOW_JUMP_JMP:
+            case InstructionType::FLOW_JUMP_EZ:
+            case InstructionType::FLOW_JUMP_LZ:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    LinkingResult link(const ParsingResult& info){
+        const auto& [instructions, labels, addresses] = info;
+
+        LinkingResult result;
+        result.reserve(instructions.size());
+
+        for(const Instruction& instruction: instructions){
+            if(!is_branch(instruction.type)){
+                result.push_back(instruction);
+                continue;
+            }
+
+            const uint32_t id = std::get<const Label>(*(instruction.value)).id;
+            if(addresses[id] == NO_ADDRESS){
+                throw LabelDoesntExistError(std::string("COMPILATION: Label ") + labels.name(id) + " doesn't exist, referenced at " + range(instruction.from, instruction.to));
+            }
+            result.push_back(Instruction(instruction, addresses[id]));
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "Parser.hpp"
+
+namespace WS{
+    // Instructions whose FLOW_CALL / FLOW_JUMP_* entries carry their resolved target index
+    using LinkingResult = std::vector<Instruction>;
+
+    LinkingResult link(const ParsingResult& info);
+}
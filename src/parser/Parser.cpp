@@ -1,57 +1,45 @@
 #include "Parser.hpp"
 
-#define WS_UNKNOWN_TOKEN_TYPE_FOUND(offset) throw WS::UnknownTokenTypeFound(    \
-        std::string("COMPILATION: Unknown TokenType found: ")                   \
-        + std::to_string(tokens[index-offset].type)                             \
-        + " at " + std::to_string(tokens[index-offset].position)                \
+#define WS_UNKNOWN_TOKEN_TYPE_FOUND(token) throw WS::UnknownTokenTypeFound(    \
+        std::string("COMPILATION: Unknown TokenType found: ")                  \
+        + std::to_string(token.type)                                           \
+        + " at " + std::to_string(token.position)                              \
     )
 
-#define WS_UNEXPECTED_TOKEN(type, offset) throw UnexpectedToken(    \
+#define WS_UNEXPECTED_TOKEN(type, token) throw UnexpectedToken(     \
         std::string("COMPILATION: Error at ")                       \
-        + std::string(tokens.at(index-offset))                      \
+        + std::string(token)                                        \
         + ": Unexpected " #type " token"                            \
     )
 
 namespace WS{
-    ParsingResult parse_tokens(const std::vector<Token>& tokens){
+    ParsingResult parse_tokens(TokenStream tokens){
         std::vector<Instruction> result;
-        std::unordered_map<Label, size_t, LabelHash> label_addresses;
-        size_t index = 0;
-
-        try{
-            while(index < tokens.size()){
-                Instruction new_instruction = ParseTree::parse(tokens, index);
-                if(new_instruction.type == InstructionType::FLOW_MARK){
-                    const Label& label = std::get<const Label>(*(new_instruction.value));
-                    if(label_addresses.count(label) != 0){
-                        throw LabelAlreadyExistsError(std::string("COMPILATION: Label ") + std::string(label) + " already exists");
-                    }
-                    label_addresses.insert(std::make_pair(label, result.size()));
+        LabelTable labels;
+        std::vector<size_t> label_addresses;
+
+        while(tokens.has_next()){
+            Instruction new_instruction = ParseTree::parse(tokens, tokens.index(), labels);
+            if(new_instruction.type == InstructionType::FLOW_MARK){
+                const uint32_t id = std::get<const Label>(*(new_instruction.value)).id;
+                if(id >= label_addresses.size()){
+                    label_addresses.resize(labels.size(), NO_ADDRESS);
                 }
-
-                result.push_back(new_instruction);
-                ++index;
+                if(label_addresses[id] != NO_ADDRESS){
+                    throw LabelAlreadyExistsError(std::string("COMPILATION: Label ") + labels.name(id) + " already exists");
+                }
+                label_addresses[id] = result.size();
             }
-        }
-        catch(const std::out_of_range& ex){
-            throw UnexpectedEOF(std::string("COMPILATION: Unexpected EOF at ") + std::to_string(index));
-        }
 
-        if(result.size() == 0 || result.back().type != InstructionType::EXIT){
-            result.push_back(Instruction(InstructionType::UNCLEAN_EXIT, index, index));
+            result.push_back(new_instruction);
         }
 
-        //DEBUG
-        for(const Instruction& instr: result){
-            std::cout << instr << '\n';
+        if(result.size() == 0 || result.back().type != InstructionType::EXIT){
+            result.push_back(Instruction(InstructionType::UNCLEAN_EXIT, tokens.index(), tokens.index()));
         }
 
-
-
-
-        //DEBUG END
-
-        return std::make_pair(result, label_addresses);
+        label_addresses.resize(labels.size(), NO_ADDRESS);
+        return ParsingResult{std::move(result), std::move(labels), std::move(label_addresses)};
     }
 
 
@@ -62,26 +50,27 @@ namespace WS{
     namespace ParseTree{
 
         Instruction parse WS_PARSE_ARGUMENTS(){
-            switch(tokens.at(index++).type){
+            const Token token = tokens.next();
+            switch(token.type){
                 case TokenType::SPACE:
-                    return Stack::parse(tokens, index);
+                    return Stack::parse(tokens, start, labels);
                 case TokenType::TAB:
-                    return Middle::parse(tokens, index);
+                    return Middle::parse(tokens, start, labels);
                 case TokenType::NEWLINE:
-                    return Flow::parse(tokens, index);
+                    return Flow::parse(tokens, start, labels);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND(1);
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
             }
         }
 
 
         namespace Value{
-            long long number WS_PARSE_ARGUMENTS(){
+            Number number(TokenStream& tokens, const Token& sign){
                 bool is_negative;
 
-                switch(tokens[index].type){
+                switch(sign.type){
                     case TokenType::NEWLINE:
-                        throw NumberFormatError(std::string("COMPILATION: Error at ") + std::string(tokens[index]) + ": Number can't start with a NEWLINE");
+                        throw NumberFormatError(std::string("COMPILATION: Error at ") + std::string(sign) + ": Number can't start with a NEWLINE");
                     case TokenType::SPACE:
                         is_negative = false;
                         break;
@@ -89,272 +78,300 @@ namespace WS{
                         is_negative = true;
                         break;
                     default:
-                        WS_UNKNOWN_TOKEN_TYPE_FOUND(0);
+                        WS_UNKNOWN_TOKEN_TYPE_FOUND(sign);
                 }
 
-                long long result = 0;
+                unsigned long long magnitude = 0;
+                std::optional<BigInt> exact;
                 bool parsing = true;
 
                 while (parsing)
                 {
-                    const Token& token = tokens.at(++index);
+                    const Token token = tokens.next();
+                    unsigned bit;
                     switch(token.type){
                         case TokenType::NEWLINE:
                             parsing = false;
-                            break;
+                            continue;
                         case TokenType::SPACE:
-                            result <<= 1;
+                            bit = 0;
                             break;
                         case TokenType::TAB:
-                            result <<= 1;
-                            ++result;
+                            bit = 1;
                             break;
                         default:
-                            WS_UNKNOWN_TOKEN_TYPE_FOUND(0);
+                            WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
                     }
-                }
-                if(is_negative){
-                    result *= -1;
+                    if(!exact && (magnitude >> 62) != 0){
+                        exact = BigInt(static_cast<long long>(magnitude));    // The next bit might not fit anymore
+                    }
+                    if(exact){
+                        exact->multiply_add(2, bit);
+                    }
+                    magnitude = (magnitude << 1) | bit;
                 }
 
-                return result;
+                const long long result = static_cast<long long>(is_negative ? 0ULL - magnitude : magnitude);
+                if(exact && is_negative){
+                    exact = -*exact;
+                }
+                if(exact && exact->fits()){
+                    exact.reset();
+                }
+                return Number{result, exact};
             }
 
-            Label label WS_PARSE_ARGUMENTS(){
-                std::vector<Token> result;
-                bool parsing = true;
+            Label label(TokenStream& tokens, LabelTable& labels){
+                LabelTable::Node node = LabelTable::ROOT;
 
-                while(parsing){
-                    const Token token = tokens.at(index);
-                    result.push_back(token);
-                    if(token.type == TokenType::NEWLINE){
-                        break;
-                    }
-                    else{
-                        ++index;
+                while(true){
+                    const Token token = tokens.next();
+                    switch(token.type){
+                        case TokenType::SPACE:
+                            node = labels.step(node, false);
+                            break;
+                        case TokenType::TAB:
+                            node = labels.step(node, true);
+                            break;
+                        case TokenType::NEWLINE:
+                            return Label(labels.intern(node));
+                        default:
+                            WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
                     }
                 }
-
-                return result;
             }
         }
 
         WS_PARSE_INSTRUCTION(Stack){
-            switch(tokens.at(index++).type){
+            const Token token = tokens.next();
+            switch(token.type){
                 case TokenType::SPACE:
-                    return Stack::SPACE::parse(tokens, index);
+                    return Stack::SPACE::parse(tokens, start, labels);
                 case TokenType::TAB:
-                    return Stack::TAB::parse(tokens, index);
+                    return Stack::TAB::parse(tokens, start, labels);
                 case TokenType::NEWLINE:
-                    return Stack::NEWLINE::parse(tokens, index);
+                    return Stack::NEWLINE::parse(tokens, start, labels);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND(1);
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
             }
         }
 
         WS_PARSE_INSTRUCTION(Stack::SPACE){
-            const size_t start = index - 2;
-            const long long parsed_number = Value::number(tokens, index);
-            return Instruction(InstructionType::STACK_PUSH, start, index, parsed_number); 
+            const Value::Number parsed_number = Value::number(tokens, tokens.next());
+            if(parsed_number.exact){
+                return Instruction(InstructionType::STACK_PUSH, start, tokens.index() - 1, *parsed_number.exact);
+            }
+            return Instruction(InstructionType::STACK_PUSH, start, tokens.index() - 1, parsed_number.value); 
         }
 
         WS_PARSE_INSTRUCTION(Stack::TAB){
-            const size_t start = index - 2;
-            switch(tokens.at(index++).type){
+            const Token token = tokens.next();
+            switch(token.type){
                 case TokenType::SPACE:
                     {
-                        const long long parsed_number = Value::number(tokens, index);
+                        const Token sign = tokens.next();
+                        const long long parsed_number = Value::number(tokens, sign).value;
                         if(parsed_number < 0){
-                            throw NumberFormatError(std::string("Error at ") + std::string(tokens[start+3]) + ": Number must not be negative");
+                            throw NumberFormatError(std::string("Error at ") + std::string(sign) + ": Number must not be negative");
                         }
-                        return Instruction(InstructionType::STACK_DUP_N, start, index, parsed_number);
+                        return Instruction(InstructionType::STACK_DUP_N, start, tokens.index() - 1, parsed_number);
                     }
                 case TokenType::NEWLINE:
                     {
-                        const long long parsed_number = Value::number(tokens, index);
-                        return Instruction(InstructionType::STACK_DISCARD_N, start, index, parsed_number);
+                        const long long parsed_number = Value::number(tokens, tokens.next()).value;
+                        return Instruction(InstructionType::STACK_DISCARD_N, start, tokens.index() - 1, parsed_number);
                     }
                 case TokenType::TAB:
-                    WS_UNEXPECTED_TOKEN(TAB, 1);
+                    WS_UNEXPECTED_TOKEN(TAB, token);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND(1);
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
             }
         }
 
         WS_PARSE_INSTRUCTION(Stack::NEWLINE){
-            switch(tokens.at(index).type){
+            const Token token = tokens.next();
+            switch(token.type){
                 case TokenType::SPACE:
-                    return Instruction(InstructionType::STACK_DUP_TOP, index-2, index);
+                    return Instruction(InstructionType::STACK_DUP_TOP, start, tokens.index() - 1);
                 case TokenType::TAB:
-                    return Instruction(InstructionType::STACK_SWAP, index-2, index);
+                    return Instruction(InstructionType::STACK_SWAP, start, tokens.index() - 1);
                 case TokenType::NEWLINE:
-                    return Instruction(InstructionType::STACK_DISCARD_TOP, index-2, index);
+                    return Instruction(InstructionType::STACK_DISCARD_TOP, start, tokens.index() - 1);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND(0);
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
             }
         }
 
         WS_PARSE_INSTRUCTION(Middle){
-            switch(tokens.at(index++).type){
+            const Token token = tokens.next();
+            switch(token.type){
                 case TokenType::SPACE:
-                    return Middle::Arithmetic::parse(tokens, index);
+                    return Middle::Arithmetic::parse(tokens, start, labels);
                 case TokenType::TAB:
-                    return Middle::Heap::parse(tokens, index);
+                    return Middle::Heap::parse(tokens, start, labels);
                 case TokenType::NEWLINE:
-                    return Middle::OutputInput::parse(tokens, index);
+                    return Middle::OutputInput::parse(tokens, start, labels);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND(1);
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
             }
         }
         
         WS_PARSE_INSTRUCTION(Middle::Arithmetic){
-            switch(tokens.at(index++).type){
+            const Token token = tokens.next();
+            switch(token.type){
                 case TokenType::SPACE:
-                    return Middle::Arithmetic::SPACE::parse(tokens, index);
+                    return Middle::Arithmetic::SPACE::parse(tokens, start, labels);
                 case TokenType::TAB:
-                    return Middle::Arithmetic::TAB::parse(tokens, index);
+                    return Middle::Arithmetic::TAB::parse(tokens, start, labels);
                 case TokenType::NEWLINE:
-                    WS_UNEXPECTED_TOKEN(NEWLINE, 1);
+                    WS_UNEXPECTED_TOKEN(NEWLINE, token);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND(1);
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
             }
         }
 
         WS_PARSE_INSTRUCTION(Middle::Arithmetic::SPACE){
-            switch(tokens.at(index).type){
+            const Token token = tokens.next();
+            switch(token.type){
                 case TokenType::SPACE:
-                    return Instruction(InstructionType::ARITHMETIC_ADD, index-3, index);
+                    return Instruction(InstructionType::ARITHMETIC_ADD, start, tokens.index() - 1);
                 case TokenType::TAB:
-                    return Instruction(InstructionType::ARITHMETIC_SUB, index-3, index);
+                    return Instruction(InstructionType::ARITHMETIC_SUB, start, tokens.index() - 1);
                 case TokenType::NEWLINE:
-                    return Instruction(InstructionType::ARITHMETIC_MULTIPLICATE, index-3, index);
+                    return Instruction(InstructionType::ARITHMETIC_MULTIPLICATE, start, tokens.index() - 1);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND(0);
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
             }
         }
 
         WS_PARSE_INSTRUCTION(Middle::Arithmetic::TAB){
-            switch(tokens.at(index).type){
+            const Token token = tokens.next();
+            switch(token.type){
                 case TokenType::SPACE:
-                    return Instruction(InstructionType::ARITHMETIC_DIVIDE, index-3, index);
+                    return Instruction(InstructionType::ARITHMETIC_DIVIDE, start, tokens.index() - 1);
                 case TokenType::TAB:
-                    return Instruction(InstructionType::ARITHMETIC_MODULO, index-3, index);
+                    return Instruction(InstructionType::ARITHMETIC_MODULO, start, tokens.index() - 1);
                 case TokenType::NEWLINE:
-                    WS_UNEXPECTED_TOKEN(NEWLINE, 0);
+                    WS_UNEXPECTED_TOKEN(NEWLINE, token);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND(0);
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
             }
         }
 
         WS_PARSE_INSTRUCTION(Middle::Heap){
-            switch(tokens.at(index).type){
+            const Token token = tokens.next();
+            switch(token.type){
                 case TokenType::SPACE:
-                    return Instruction(InstructionType::HEAP_POP, index-2, index);
+                    return Instruction(InstructionType::HEAP_POP, start, tokens.index() - 1);
                 case TokenType::TAB:
-                    return Instruction(InstructionType::HEAP_PUSH, index-2, index);
+                    return Instruction(InstructionType::HEAP_PUSH, start, tokens.index() - 1);
                 case TokenType::NEWLINE:
-                    WS_UNEXPECTED_TOKEN(NEWLINE, 0);
+                    WS_UNEXPECTED_TOKEN(NEWLINE, token);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND(0);
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
             }
         }
 
         WS_PARSE_INSTRUCTION(Middle::OutputInput){
-            switch(tokens.at(index++).type){
+            const Token token = tokens.next();
+            switch(token.type){
                 case TokenType::SPACE:
-                    return Middle::OutputInput::Output::parse(tokens, index);
+                    return Middle::OutputInput::Output::parse(tokens, start, labels);
                 case TokenType::TAB:
-                    return Middle::OutputInput::Input::parse(tokens, index);
+                    return Middle::OutputInput::Input::parse(tokens, start, labels);
                 case TokenType::NEWLINE:
-                    WS_UNEXPECTED_TOKEN(NEWLINE, 1);
+                    WS_UNEXPECTED_TOKEN(NEWLINE, token);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND(1);
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
             }
         }
 
         WS_PARSE_INSTRUCTION(Middle::OutputInput::Output){
-            switch(tokens.at(index).type){
+            const Token token = tokens.next();
+            switch(token.type){
                 case TokenType::SPACE:
-                    return Instruction(InstructionType::OUTPUT_CHAR, index-3, index);
+                    return Instruction(InstructionType::OUTPUT_CHAR, start, tokens.index() - 1);
                 case TokenType::TAB:
-                    return Instruction(InstructionType::OUTPUT_NUM, index-3, index);
+                    return Instruction(InstructionType::OUTPUT_NUM, start, tokens.index() - 1);
                 case TokenType::NEWLINE:
-                    WS_UNEXPECTED_TOKEN(NEWLINE, 0);
+                    WS_UNEXPECTED_TOKEN(NEWLINE, token);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND(0);
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
             }
         }
 
         WS_PARSE_INSTRUCTION(Middle::OutputInput::Input){
-            switch(tokens.at(index).type){
+            const Token token = tokens.next();
+            switch(token.type){
                 case TokenType::SPACE:
-                    return Instruction(InstructionType::INPUT_CHAR, index-3, index);
+                    return Instruction(InstructionType::INPUT_CHAR, start, tokens.index() - 1);
                 case TokenType::TAB:
-                    return Instruction(InstructionType::INPUT_NUM, index-3, index);
+                    return Instruction(InstructionType::INPUT_NUM, start, tokens.index() - 1);
                 case TokenType::NEWLINE:
-                    WS_UNEXPECTED_TOKEN(NEWLINE, 0);
+                    WS_UNEXPECTED_TOKEN(NEWLINE, token);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND(0);
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
             }
         }
 
         WS_PARSE_INSTRUCTION(Flow){
-            switch(tokens.at(index++).type){
+            const Token token = tokens.next();
+            switch(token.type){
                 case TokenType::SPACE:
-                    return Flow::SPACE::parse(tokens, index);
+                    return Flow::SPACE::parse(tokens, start, labels);
                 case TokenType::TAB:
-                    return Flow::TAB::parse(tokens, index);
+                    return Flow::TAB::parse(tokens, start, labels);
                 case TokenType::NEWLINE:
-                    return Flow::EXIT::parse(tokens, index);
+                    return Flow::EXIT::parse(tokens, start, labels);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND(1);
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
             }
         }
 
         WS_PARSE_INSTRUCTION(Flow::SPACE){
-            const size_t saved_index = index++;
-            const Label label = Value::label(tokens, index);
-            switch(tokens[saved_index].type){    // If Value::label(...) didn't throw at tokens.at, then this is safe
+            const Token token = tokens.next();
+            const Label label = Value::label(tokens, labels);
+            switch(token.type){
                 case TokenType::SPACE:
-                    return Instruction(InstructionType::FLOW_MARK, saved_index-2, index, label);
+                    return Instruction(InstructionType::FLOW_MARK, start, tokens.index() - 1, label);
                 case TokenType::TAB:
-                    return Instruction(InstructionType::FLOW_CALL, saved_index-2, index, label);
+                    return Instruction(InstructionType::FLOW_CALL, start, tokens.index() - 1, label);
                 case TokenType::NEWLINE:
-                    return Instruction(InstructionType::FLOW_JUMP_JMP, saved_index-2, index, label);
+                    return Instruction(InstructionType::FLOW_JUMP_JMP, start, tokens.index() - 1, label);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND((index-2));
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
             }
         }
 
         WS_PARSE_INSTRUCTION(Flow::TAB){
-            const size_t start = index;
-            switch(tokens.at(index++).type){
+            const Token token = tokens.next();
+            switch(token.type){
                 case TokenType::SPACE: {
-                    const Label label = Value::label(tokens, index);
-                    return Instruction(InstructionType::FLOW_JUMP_EZ, start-2, index, label);
+                    const Label label = Value::label(tokens, labels);
+                    return Instruction(InstructionType::FLOW_JUMP_EZ, start, tokens.index() - 1, label);
                 }
                 case TokenType::TAB: {
-                    const Label label = Value::label(tokens, index);
-                    return Instruction(InstructionType::FLOW_JUMP_LZ, start-2, index, label);
+                    const Label label = Value::label(tokens, labels);
+                    return Instruction(InstructionType::FLOW_JUMP_LZ, start, tokens.index() - 1, label);
                 }
                 case TokenType::NEWLINE:
-                    --index; //Backtrack
-                    return Instruction(InstructionType::FLOW_RETURN, index-2, index);
+                    return Instruction(InstructionType::FLOW_RETURN, start, tokens.index() - 1);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND(1);
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
             }
         }
 
         WS_PARSE_INSTRUCTION(Flow::EXIT){
-            switch(tokens.at(index).type){
+            const Token token = tokens.next();
+            switch(token.type){
                 case TokenType::NEWLINE:
-                    return Instruction(InstructionType::EXIT, index-2, index);
+                    return Instruction(InstructionType::EXIT, start, tokens.index() - 1);
                 case TokenType::SPACE:
-                    WS_UNEXPECTED_TOKEN(SPACE, 0);
+                    WS_UNEXPECTED_TOKEN(SPACE, token);
                 case TokenType::TAB:
-                    WS_UNEXPECTED_TOKEN(TAB, 0);
+                    WS_UNEXPECTED_TOKEN(TAB, token);
                 default:
-                    WS_UNKNOWN_TOKEN_TYPE_FOUND(0);
+                    WS_UNKNOWN_TOKEN_TYPE_FOUND(token);
                 
             }
         }
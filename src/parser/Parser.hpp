@@ -1,23 +1,38 @@
 #pragma once
-#include <unordered_map>
+#include <cstdint>
 
 #include "Instruction.hpp"
 #include "../exceptions/Exceptions.hpp"
 
-#define WS_PARSE_ARGUMENTS() (const std::vector<Token>& tokens, size_t& index)
+#define WS_PARSE_ARGUMENTS() (TokenStream& tokens, const size_t start, [[maybe_unused]] LabelTable& labels)
 #define WS_PARSE_INSTRUCTION(ns) Instruction ns::parse WS_PARSE_ARGUMENTS()
 #define WS_PARSE_DECLARATION() Instruction parse WS_PARSE_ARGUMENTS()
 
 namespace WS{
-    using ParsingResult = std::pair<const std::vector<Instruction>, const std::unordered_map<Label, size_t, LabelHash>>;
+    constexpr size_t NO_ADDRESS = SIZE_MAX;
 
-    ParsingResult parse_tokens(const std::vector<Token>& tokens);
+    struct ParsingResult{
+        const std::vector<Instruction> instructions;
+        const LabelTable labels;
+        const std::vector<size_t> label_addresses;      // Label id -> index of its FLOW_MARK, NO_ADDRESS if it is never marked
+    };
+
+    // Parses straight from the stream, start is the token index of the instruction's first token.
+    // Labels are interned into labels as they are read
+    ParsingResult parse_tokens(TokenStream tokens);
     namespace ParseTree{
         WS_PARSE_DECLARATION();
 
         namespace Value{
-            long long number WS_PARSE_ARGUMENTS();
-            Label label WS_PARSE_ARGUMENTS();
+            // value wraps around like a long long would, exact is only set if the literal doesn't fit one
+            struct Number{
+                long long value;
+                std::optional<BigInt> exact;
+            };
+
+            // sign is the already taken first token of the number
+            Number number(TokenStream& tokens, const Token& sign);
+            Label label(TokenStream& tokens, LabelTable& labels);
         }
 
         namespace Stack{
@@ -1,4 +1,15 @@
 #include "Tokenizer.hpp"
+#include "../exceptions/Exceptions.hpp"
+
+// -DWS_SCAN_SCALAR leaves only the byte by byte loop, to compare against it in make bench
+#if defined(WS_SCAN_SCALAR)
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define WS_SCAN_AVX2 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define WS_SCAN_SSE2 1
+#endif
 
 namespace WS{
     std::optional<TokenType::TokenType> char_to_type(const char &c)
@@ -16,24 +27,85 @@ namespace WS{
         }
     }
 
-    std::vector<Token> tokenize(std::string_view plain_text)
+    size_t find_whitespace(std::string_view plain_text, size_t from)
     {
         const size_t length = plain_text.length();
+        const char* data = plain_text.data();
 
-        std::vector<Token> result;
-        result.reserve(length);
-
-        std::optional<TokenType::TokenType> possible_type;
-
-        for (size_t i = 0; i < length; ++i)
+#if defined(WS_SCAN_AVX2)
+        const __m256i space = _mm256_set1_epi8(' ');
+        const __m256i tab = _mm256_set1_epi8('\t');
+        const __m256i newline = _mm256_set1_epi8('\n');
+        for (; from + 32 <= length; from += 32)
+        {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + from));
+            const __m256i hits = _mm256_or_si256(
+                _mm256_cmpeq_epi8(chunk, space),
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, tab), _mm256_cmpeq_epi8(chunk, newline))
+            );
+            const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+            if (mask != 0)
+            {
+                return from + __builtin_ctz(mask);
+            }
+        }
+#elif defined(WS_SCAN_SSE2)
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i newline = _mm_set1_epi8('\n');
+        for (; from + 16 <= length; from += 16)
         {
-            possible_type = char_to_type(plain_text[i]);
-            if (possible_type.has_value())
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + from));
+            const __m128i hits = _mm_or_si128(
+                _mm_cmpeq_epi8(chunk, space),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, tab), _mm_cmpeq_epi8(chunk, newline))
+            );
+            const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+            if (mask != 0)
             {
-                result.emplace_back(*possible_type, i);
+                return from + __builtin_ctz(mask);
             }
         }
+#endif
 
-        return result;
+        while (from < length && !char_to_type(data[from]).has_value())
+        {
+            ++from;
+        }
+        return from;
+    }
+
+    TokenStream::TokenStream(std::string_view plain_text): plain_text(plain_text), position(0), taken(0){}
+
+    bool TokenStream::has_next()
+    {
+        const size_t length = plain_text.length();
+        if (position < length && char_to_type(plain_text[position]).has_value())
+        {
+            return true;    // Most tokens directly follow the previous one, don't start a scan for them
+        }
+        position = find_whitespace(plain_text, position);
+        return position < length;
+    }
+
+    Token TokenStream::next()
+    {
+        if (!has_next())
+        {
+            throw UnexpectedEOF(std::string("COMPILATION: Unexpected EOF at ") + std::to_string(position));
+        }
+        ++taken;
+        const size_t at = position++;
+        return Token(*char_to_type(plain_text[at]), at);
+    }
+
+    size_t TokenStream::index() const
+    {
+        return taken;
+    }
+
+    TokenStream tokenize(std::string_view plain_text)
+    {
+        return TokenStream(plain_text);
     }
-}
\ No newline at end of file
+}
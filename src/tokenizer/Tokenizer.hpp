@@ -1,9 +1,38 @@
 #pragma once
-#include <vector>
+#include <string_view>
 #include "Token.hpp"
 
 namespace WS{
     std::optional<TokenType::TokenType> char_to_type(const char &c);
 
-    std::vector<Token> tokenize(std::string_view plain_text);
-}
\ No newline at end of file
+    // Offset of the first space, tab or newline at or after from, plain_text.length() if there is none.
+    // Scans 32 (AVX2) or 16 (SSE2) bytes at a time where the build allows it
+    size_t find_whitespace(std::string_view plain_text, size_t from);
+
+    // Hands out the tokens of a source one at a time, every character that isn't whitespace is a comment and skipped.
+    // Only views the source, which has to outlive the stream
+    class TokenStream{
+    private:
+        const std::string_view plain_text;
+        size_t position;        // Offset of the first character not looked at yet
+        size_t taken;           // Number of tokens handed out so far
+
+    public:
+        TokenStream() = delete;
+        TokenStream(std::string_view plain_text);
+        TokenStream(const TokenStream&) = default;
+        TokenStream& operator=(const TokenStream&) = delete;
+        TokenStream& operator=(TokenStream&&) = delete;
+
+        // Whether another token follows, skips the comments up to it
+        bool has_next();
+
+        // Throws UnexpectedEOF if the source is exhausted
+        Token next();
+
+        // Index the next token will have, counted in tokens rather than characters
+        size_t index() const;
+    };
+
+    TokenStream tokenize(std::string_view plain_text);
+}
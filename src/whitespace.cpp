@@ -1,8 +1,95 @@
+#include <stdexcept>
+
 #include "whitespace.hpp"
 #include "interpreter/Interpreter.hpp"
+#include "emitter/CEmitter.hpp"
+#include "optimizer/Optimizer.hpp"
+#include "bytecode/ProgramFile.hpp"
+#include "bytecode/Listing.hpp"
+#include "exceptions/Exceptions.hpp"
 
 namespace WS{
-    std::string whitespace(const std::string &code, const std::string &inp){
-        return interpret(parse_tokens(tokenize(code)), std::stringstream(inp));
+    CompiledProgram::CompiledProgram(Bytecode&& bytecode, LabelTable&& labels, const Options& options):
+        bytecode(std::move(bytecode)), labels(std::move(labels)), options(options), prepared(prepare(this->bytecode, options.engine, options.limits)){}
+
+    CompiledProgram compile_program(std::string_view code, const Options& options){
+        const ParsingResult parsed = parse_tokens(tokenize(code));
+        Bytecode bytecode = compile(link(parsed), options.engine == Engine::BIGNUM);
+        if(options.optimize){
+            return CompiledProgram(optimize(bytecode), LabelTable(parsed.labels), options);
+        }
+        return CompiledProgram(std::move(bytecode), LabelTable(parsed.labels), options);
+    }
+
+    void save_program(const CompiledProgram& program, std::ostream& output){
+        uint32_t flags = 0;
+        if(program.options.engine == Engine::BIGNUM){
+            flags |= ProgramFile::Flags::EXACT_LITERALS;
+        }
+        if(program.options.optimize){
+            flags |= ProgramFile::Flags::OPTIMIZED;
+        }
+        ProgramFile::write(program.bytecode, program.labels, flags, output);
+    }
+
+    CompiledProgram load_program(std::string_view image, const Options& options){
+        ProgramFile::Image loaded = ProgramFile::read(image);
+        if(options.engine == Engine::BIGNUM && (loaded.flags & ProgramFile::Flags::EXACT_LITERALS) == 0){
+            throw InvalidProgramImage("COMPILATION: The program image wraps wide literals to 64 bits, compile it with --engine=bignum to run it on the bignum engine");
+        }
+
+        Options loaded_options = options;
+        loaded_options.optimize = (loaded.flags & ProgramFile::Flags::OPTIMIZED) != 0;
+        return CompiledProgram(std::move(loaded.bytecode), std::move(loaded.labels), loaded_options);
+    }
+
+    void dump_ir(const CompiledProgram& program, std::ostream& output){
+        write_listing(program.bytecode, program.labels, output);
+    }
+
+    void run(const CompiledProgram& program, Input& input, Output& output){
+        interpret(program.bytecode, program.prepared, input, output, program.options.limits);
+    }
+
+    void write_profile(const CompiledProgram& program, const Profiler& profiler, std::ostream& report, std::ostream* folded){
+        profiler.report(program.bytecode, program.labels, report);
+        if(folded != nullptr){
+            profiler.write_folded(program.bytecode, program.labels, *folded);
+        }
+    }
+
+    void profile(const CompiledProgram& program, Input& input, Output& output, std::ostream& report, std::ostream* folded){
+        if(program.options.engine == Engine::BIGNUM){
+            throw std::invalid_argument("Profiling runs on the switch engine, which can't run programs compiled for the bignum engine");
+        }
+
+        Profiler profiler(program.bytecode.size());
+        try{
+            interpret_profiled(program.bytecode, input, output, profiler, program.options.limits);
+        }
+        catch(...){
+            write_profile(program, profiler, report, folded);
+            throw;
+        }
+        write_profile(program, profiler, report, folded);
+    }
+
+    std::string run(const CompiledProgram& program, const std::string& inp){
+        StringInput input(inp);
+        StringOutput output;
+        run(program, input, output);
+        return output.str();
+    }
+
+    std::string whitespace(std::string_view code, const std::string &inp, const Options& options){
+        return run(compile_program(code, options), inp);
+    }
+
+    void whitespace(std::string_view code, Input& input, Output& output, const Options& options){
+        run(compile_program(code, options), input, output);
+    }
+
+    void emit_c(std::string_view code, std::ostream& output, const size_t max_call_depth){
+        emit_c(compile(link(parse_tokens(tokenize(code)))), output, max_call_depth);
     }
-}
\ No newline at end of file
+}
@@ -1,6 +1,61 @@
 #pragma once
+#include <ostream>
 #include <string>
+#include <string_view>
+
+#include "Options.hpp"
+#include "bytecode/Bytecode.hpp"
+#include "interpreter/Input.hpp"
+#include "interpreter/Output.hpp"
+#include "interpreter/Prepared.hpp"
 
 namespace WS{
-    std::string whitespace(const std::string &code, const std::string &inp = std::string());
-}
\ No newline at end of file
+    // A program that went through the whole front end once. It never changes after compile_program, so one instance
+    // can be run any number of times, also from several threads at once; every run gets its own Context.
+    // What options.engine needs before running is prepared along with it, copies share the jit's native code
+    class CompiledProgram{
+    public:
+        const Bytecode bytecode;
+        const LabelTable labels;    // Names of the FLOW_MARK label ids, only read for diagnostics and save_program
+        const Options options;
+        const Prepared prepared;    // For options.engine and options.limits, see interpreter/Prepared.hpp
+
+        CompiledProgram() = delete;
+        CompiledProgram(Bytecode&& bytecode, LabelTable&& labels, const Options& options);
+        CompiledProgram(const CompiledProgram& program) = default;
+        CompiledProgram(CompiledProgram&& program) = default;
+        CompiledProgram& operator=(const CompiledProgram&) = delete;
+        CompiledProgram& operator=(CompiledProgram&&) = delete;
+    };
+
+    // Tokenizes, parses, links, compiles and optimizes the program for options.engine, raises WhitespaceCompileError
+    CompiledProgram compile_program(std::string_view code, const Options& options = Options());
+
+    // Writes the program as a .wsc image, see bytecode/ProgramFile.hpp
+    void save_program(const CompiledProgram& program, std::ostream& output);
+
+    // Takes the program from a .wsc image instead of compiling it, options.optimize is ignored in favour of how the image was built.
+    // Raises InvalidProgramImage for a damaged image or one compiled without exact literals when options.engine is BIGNUM
+    CompiledProgram load_program(std::string_view image, const Options& options = Options());
+
+    // Lists the bytecode the engines would run, one instruction per line, see bytecode/Listing.hpp
+    void dump_ir(const CompiledProgram& program, std::ostream& output);
+
+    // Runs the program on the switch engine under a Profiler and writes its hot-spot report to report and, unless folded is null,
+    // its folded call stacks to folded, also if the program raises.
+    // Raises std::invalid_argument for programs compiled for the bignum engine, their values wouldn't fit
+    void profile(const CompiledProgram& program, Input& input, Output& output, std::ostream& report, std::ostream* folded = nullptr);
+
+    // Runs the program under its options.limits, only sets up a fresh Context, Budget and stacks.
+    // output is flushed when this returns or throws
+    void run(const CompiledProgram& program, Input& input, Output& output);
+    std::string run(const CompiledProgram& program, const std::string& inp = std::string());
+
+    std::string whitespace(std::string_view code, const std::string &inp = std::string(), const Options& options = Options());
+
+    // Reads the program input incrementally and streams the program output into output, which is flushed when this returns or throws
+    void whitespace(std::string_view code, Input& input, Output& output, const Options& options = Options());
+
+    // Translates the program into a standalone C++ source, see emitter/CEmitter.hpp
+    void emit_c(std::string_view code, std::ostream& output, size_t max_call_depth = Limits::DEFAULT_CALL_DEPTH);
+}
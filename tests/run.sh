@@ -0,0 +1,85 @@
+#!/bin/sh
+# Runs every program in tests/ and tests/errors/ on every engine, with and without the optimizer,
+# and translated with --emit-c, and compares what it prints, runtime and compilation errors included, to the unoptimized switch engine.
+# USAGE: tests/run.sh [<path to the whitespace binary, relative to the repository>]
+cd "$(dirname "$0")/.." || exit 1
+BINARY=${1:-./dest/whitespace}
+CXX=${CXX:-c++}
+ENGINES="switch threaded jit bignum"
+failures=0
+runs=0
+EXPECTED=$(mktemp)
+ACTUAL=$(mktemp)
+TRANSLATION=$(mktemp -d)
+trap 'rm -rf "$EXPECTED" "$ACTUAL" "$TRANSLATION"' EXIT
+
+# Compares the output of one run, given as the remaining arguments, to $reference
+check(){
+    label=$1
+    shift
+    runs=$((runs + 1))
+    actual=$("$@" 2>&1)
+    if [ "$actual" != "$reference" ]; then
+        failures=$((failures + 1))
+        echo "FAILED: $program $label"
+        printf '%s\n' "$reference" > "$EXPECTED"
+        printf '%s\n' "$actual" > "$ACTUAL"
+        diff "$EXPECTED" "$ACTUAL" | head -20
+    fi
+}
+
+# Runs the program translated with --emit-c
+translated(){
+    "$CXX" -std=c++17 -O1 -o "$TRANSLATION/program" "$TRANSLATION/program.cpp" || return
+    "$TRANSLATION/program" "$@"
+}
+
+# Inputs that take the programs through their interesting paths, the programs in tests/errors/ need none
+inputs(){
+    case "$1" in
+        tests/add_input.ws) echo "20 0x16";;
+        tests/factorial.ws) echo "20";;
+        tests/fib.ws) echo "40";;
+        tests/hello_user.ws) echo "World";;
+        tests/reverse.ws) echo "Reverse_me!";;
+        tests/tower.ws) echo "6";;
+        tests/errors/divide_by_zero.ws | tests/errors/modulo_by_zero.ws) echo "42";;
+    esac
+}
+
+# Limits the programs run under, always the same with and without the optimizer, see optimizer/Optimizer.hpp
+flags(){
+    case "$1" in
+        tests/errors/stack_at_limit.ws | tests/errors/stack_past_limit.ws) echo "--max-stack-depth=3";;
+        tests/errors/instructions_past_limit.ws) echo "--max-instructions=5";;
+    esac
+}
+
+for program in tests/*.ws tests/errors/*.ws; do
+    # Word splitting is intended, every word is one flag or input
+    expected=$("$BINARY" --engine=switch --no-optimize $(flags "$program") "$program" $(inputs "$program") 2>&1)
+    reference=$expected
+    for engine in $ENGINES; do
+        for optimize in "" "--no-optimize"; do
+            if [ "$engine" = switch ] && [ -n "$optimize" ]; then
+                continue
+            fi
+            check "--engine=$engine $optimize" "$BINARY" --engine="$engine" $optimize $(flags "$program") "$program" $(inputs "$program")
+        done
+    done
+    # Translated programs only know --max-call-depth
+    if [ -n "$(flags "$program")" ]; then
+        continue
+    fi
+    if "$BINARY" --emit-c="$TRANSLATION/program.cpp" "$program" > /dev/null; then
+        check "--emit-c" translated $(inputs "$program")
+    else
+        # Nothing is translated, --emit-c reports the compilation error the interpreter prints after its result banner
+        reference=${expected#*"
+"}
+        check "--emit-c" "$BINARY" --emit-c="$TRANSLATION/program.cpp" "$program"
+    fi
+done
+
+echo "$((runs - failures)) of $runs runs matched --engine=switch --no-optimize"
+[ "$failures" -eq 0 ]